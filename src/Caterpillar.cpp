@@ -167,27 +167,3 @@ int Caterpillar::getVoltage() const {
 
     return (int)(voltage * 100); // V -> mV 変換
 }
-
-/**
- * @brief スライダー値(0-255)をモーター速度(0-255)に変換します。
- * 128を中央値0とし、それより大きい/小さい値に応じて速度を決定します。
- * @param slideVal [in] 変換元のスライダー値 (0-255)。
- * @return int 変換後のモーター速度 (0-255)。
- */
-int Caterpillar::transformSlideValue(int slideVal) const {
-    // 入力値を0-255の範囲に収めます
-    slideVal = constrain(slideVal, 0, 255);
-
-    if (slideVal == 128) {
-        return 0;
-    } else if (slideVal > 128) {
-        int diff = slideVal - 128;
-        // 差分を0-255の範囲に線形変換します
-        int scaledValue = round((double)diff * 255.0 / 127.0);
-        return constrain(scaledValue, 0, 255);
-    } else { // slideVal < 128
-        int diff = 128 - slideVal;
-        int scaledValue = round((double)diff * 255.0 / 128.0);
-        return constrain(scaledValue, 0, 255);
-    }
-}
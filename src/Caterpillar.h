@@ -104,14 +104,6 @@ public:
      */
     int getVoltage() const;
 
-    /**
-     * @brief スライダー値(0-255)をモーター速度(0-255)に変換します。
-     * 128を中央値0とし、それより大きい/小さい値に応じて速度を決定します。
-     * @param slideVal [in] 変換元のスライダー値 (0-255)。
-     * @return int 変換後のモーター速度 (0-255)。
-     */
-    int transformSlideValue(int slideVal) const;
-
 private:
     // --- ピン番号 ---
     int _in1, _in2, _in3, _in4;             // モーター制御ピン
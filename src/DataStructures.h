@@ -1,6 +1,8 @@
 #ifndef DATA_STRUCTURES_H
 #define DATA_STRUCTURES_H
 
+#include <Arduino.h>
+
 // --- ESP-NOW データ構造体定義 ---
 
 // 受信するデータの構造体です
@@ -19,4 +21,66 @@ struct SaneDataPacket {
   int val1; int val2; int val3; int val4; int val5; // 送信データ例
 };
 
+// --- ESP-NOW OTA フレーム定義 ---
+// OTAフレームは先頭1バイトのマジック値で制御パケットと区別します。
+// 送受信双方で同じレイアウトになるよう、すべてpackedで定義します。
+
+const uint8_t OTA_FRAME_MAGIC = 0xA5;    // OTAフレーム識別用のマジック値
+const int OTA_CHUNK_PAYLOAD_SIZE = 240;  // 1フレームで運ぶ圧縮データの最大バイト数 (ESP-NOWの最大長250バイト以内)
+
+// OTAフレームの種別です
+enum OtaFrameType : uint8_t {
+  OTA_FRAME_BEGIN = 0x01,  // 転送開始 (送信側 -> 本機)
+  OTA_FRAME_DATA  = 0x02,  // 圧縮データチャンク (送信側 -> 本機)
+  OTA_FRAME_END   = 0x03,  // 転送終了 (送信側 -> 本機)
+  OTA_FRAME_ABORT = 0x04,  // 転送中止 (送信側 -> 本機)
+  OTA_FRAME_ACK   = 0x81,  // ウィンドウ確認応答 (本機 -> 送信側)
+};
+
+// OTAの処理状態です (ACKフレームで送信側に通知します)
+enum OtaStatus : uint8_t {
+  OTA_STATUS_IDLE = 0,       // 待機中
+  OTA_STATUS_RECEIVING = 1,  // 受信中
+  OTA_STATUS_SUCCESS = 2,    // 検証完了、再起動待ち
+  OTA_STATUS_ERROR = 3,      // エラー発生 (転送を中止しました)
+};
+
+// 転送開始フレームです
+struct __attribute__((packed)) OtaBeginFrame {
+  uint8_t magic;            // OTA_FRAME_MAGIC
+  uint8_t type;             // OTA_FRAME_BEGIN
+  uint16_t chunkCount;      // 圧縮データのチャンク総数
+  uint32_t compressedSize;  // 圧縮データの総バイト数
+  uint32_t imageSize;       // 展開後のファームウェアイメージのバイト数
+  uint32_t imageCrc32;      // 展開後のイメージのCRC32 (zlib互換)
+};
+
+// 圧縮データチャンクフレームです (zlib形式のストリームを分割したもの)
+// 制御パケットと長さが重ならないよう、最後のチャンクも含めて常にsizeof(OtaDataFrame)で送信します。
+// 受信側はこれ以外の長さのデータフレームを破棄します。
+struct __attribute__((packed)) OtaDataFrame {
+  uint8_t magic;            // OTA_FRAME_MAGIC
+  uint8_t type;             // OTA_FRAME_DATA
+  uint16_t seq;             // チャンク番号 (0から連番)
+  uint8_t length;           // payloadの有効バイト数 (1-OTA_CHUNK_PAYLOAD_SIZE)
+  uint8_t payload[OTA_CHUNK_PAYLOAD_SIZE];
+};
+
+// 転送終了・中止フレームです
+struct __attribute__((packed)) OtaControlFrame {
+  uint8_t magic;            // OTA_FRAME_MAGIC
+  uint8_t type;             // OTA_FRAME_END / OTA_FRAME_ABORT
+};
+
+// ウィンドウ確認応答フレームです
+// nextSeq未満のチャンクはすべて受信済みで、receivedBitmapのbit iが1のとき
+// チャンク(nextSeq + i)も受信済みであることを示します。送信側は0のビットを再送します。
+struct __attribute__((packed)) OtaAckFrame {
+  uint8_t magic;            // OTA_FRAME_MAGIC
+  uint8_t type;             // OTA_FRAME_ACK
+  uint8_t status;           // OtaStatus
+  uint16_t nextSeq;         // 次に必要なチャンク番号
+  uint32_t receivedBitmap;  // nextSeq以降のウィンドウ内の受信済みビットマップ
+};
+
 #endif // DATA_STRUCTURES_H
@@ -0,0 +1,145 @@
+#include "DriveMixer.h"
+
+/**
+ * @brief DriveMixerクラスのコンストラクタです。
+ * タンクミキサー、デフォルトのデッドバンド・エクスポ、速度スケール1.0で初期化します。
+ */
+DriveMixer::DriveMixer()
+    : _mode(MIX_TANK), _deadband(DEFAULT_DEADBAND), _expo(DEFAULT_EXPO),
+      _speedScale(FIXED_ONE), _reversed(false) {}
+
+/**
+ * @brief ミキサーの種類を設定します。
+ * @param mode [in] ミキサーの種類。範囲外の場合はMIX_TANKになります。
+ */
+void DriveMixer::setMode(MixMode mode) {
+    _mode = (mode < MIX_MODE_COUNT) ? mode : MIX_TANK;
+}
+
+/**
+ * @brief 現在のミキサーの種類を返します。
+ * @return MixMode ミキサーの種類です。
+ */
+MixMode DriveMixer::getMode() const {
+    return _mode;
+}
+
+/**
+ * @brief デッドバンドを設定します。
+ * @param deadband [in] デッドバンド (Q10, 0 - FIXED_ONE/2)。
+ */
+void DriveMixer::setDeadband(int deadband) {
+    _deadband = constrain(deadband, 0, FIXED_ONE / 2);
+}
+
+/**
+ * @brief エクスポを設定します。
+ * @param expo [in] 3次曲線の混合率 (Q10, 0 - FIXED_ONE)。
+ */
+void DriveMixer::setExpo(int expo) {
+    _expo = constrain(expo, 0, FIXED_ONE);
+}
+
+/**
+ * @brief 出力の速度スケールを設定します (速度ギア用)。
+ * @param scale [in] 速度スケール (Q10, 0 - FIXED_ONE)。
+ */
+void DriveMixer::setSpeedScale(int scale) {
+    _speedScale = constrain(scale, 0, FIXED_ONE);
+}
+
+/**
+ * @brief 前後反転走行を設定します。
+ * @param reversed [in] trueの場合、左右の出力を入れ替えて方向を反転します。
+ */
+void DriveMixer::setReversed(bool reversed) {
+    _reversed = reversed;
+}
+
+/**
+ * @brief スライダー値(0-255)を中央値128を0とする固定小数点値に正規化します。
+ * @param slideVal [in] スライダー値 (0-255)。
+ * @return int 正規化した値 (-FIXED_ONE - FIXED_ONE)。
+ */
+int DriveMixer::normalizeSlider(int slideVal) {
+    // 128を中心に±127の範囲に揃え、正負とも同じ係数で拡大します
+    int centered = constrain(slideVal - 128, -127, 127);
+    return centered * FIXED_ONE / 127;
+}
+
+/**
+ * @brief スライダー値からモーター速度を計算します。
+ * @param slideVal1 [in] スライダー1の値 (0-255)。
+ * @param slideVal2 [in] スライダー2の値 (0-255)。
+ * @return DriveOutput 左右のモーター速度 (-255 - 255)。
+ */
+DriveOutput DriveMixer::mix(int slideVal1, int slideVal2) const {
+    int in1 = _shapeInput(normalizeSlider(slideVal1));
+    int in2 = _shapeInput(normalizeSlider(slideVal2));
+    int motor1, motor2;
+
+    switch (_mode) {
+    case MIX_ARCADE: {
+        // in1 = 前後, in2 = 旋回 (正で右旋回 -> 右側のモーター1を遅くします)
+        motor1 = in1 - in2;
+        motor2 = in1 + in2;
+        break;
+    }
+    case MIX_CURVATURE: {
+        // 旋回量を前後速度に比例させ、速度によらず同じ旋回半径にします
+        int curvatureTurn = abs(in1) * in2 / FIXED_ONE;
+        // 前後入力がQUICK_TURN_THRESHOLD未満では超信地旋回(旋回量 = in2)を混ぜ、停止時に完全に切り替えます
+        // 混合率を前後入力に比例させることで、デッドバンドの境目でも出力が連続します
+        int quickTurnWeight = max(0, FIXED_ONE - abs(in1) * FIXED_ONE / QUICK_TURN_THRESHOLD);
+        int turn = (curvatureTurn * (FIXED_ONE - quickTurnWeight) + in2 * quickTurnWeight) / FIXED_ONE;
+        motor1 = in1 - turn;
+        motor2 = in1 + turn;
+        break;
+    }
+    case MIX_TANK:
+    default:
+        motor1 = in1;
+        motor2 = in2;
+        break;
+    }
+
+    // 飽和した場合は左右の比率を保ったまま縮小します
+    int maxMagnitude = max(abs(motor1), abs(motor2));
+    if (maxMagnitude > FIXED_ONE) {
+        motor1 = motor1 * FIXED_ONE / maxMagnitude;
+        motor2 = motor2 * FIXED_ONE / maxMagnitude;
+    }
+
+    if (_reversed) {
+        // 後ろを前として操縦するため、左右を入れ替えて方向を反転します
+        int swapped = motor1;
+        motor1 = -motor2;
+        motor2 = -swapped;
+    }
+
+    // 速度スケールを掛けてPWM値(-255 - 255)に変換します
+    DriveOutput output;
+    output.motor1 = motor1 * _speedScale / FIXED_ONE * 255 / FIXED_ONE;
+    output.motor2 = motor2 * _speedScale / FIXED_ONE * 255 / FIXED_ONE;
+    return output;
+}
+
+/**
+ * @brief 正規化した入力にデッドバンドとエクスポを適用します。
+ * @param value [in] 正規化した入力 (-FIXED_ONE - FIXED_ONE)。
+ * @return int 整形後の入力 (-FIXED_ONE - FIXED_ONE)。
+ */
+int DriveMixer::_shapeInput(int value) const {
+    int magnitude = abs(value);
+    if (magnitude <= _deadband) {
+        return 0;
+    }
+    // デッドバンドの外側を0からFIXED_ONEに再スケールし、端で不連続にならないようにします
+    magnitude = (magnitude - _deadband) * FIXED_ONE / (FIXED_ONE - _deadband);
+
+    // y = (1 - e) * x + e * x^3
+    int cubic = magnitude * magnitude / FIXED_ONE * magnitude / FIXED_ONE;
+    magnitude = (magnitude * (FIXED_ONE - _expo) + cubic * _expo) / FIXED_ONE;
+
+    return (value < 0) ? -magnitude : magnitude;
+}
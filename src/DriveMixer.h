@@ -0,0 +1,103 @@
+#ifndef DRIVEMIXER_H
+#define DRIVEMIXER_H
+
+#include <Arduino.h>
+
+// ミキサーの種類です
+enum MixMode : uint8_t {
+  MIX_TANK = 0,     // タンク: スライダー1 -> モーター1, スライダー2 -> モーター2
+  MIX_ARCADE,       // アーケード: スライダー1 = 前後, スライダー2 = 旋回 (左右の和と差)
+  MIX_CURVATURE,    // カーブ: スライダー2で旋回半径を指定 (低速では超信地旋回に徐々に移行)
+  MIX_MODE_COUNT    // ミキサーの数
+};
+
+// ミキサーの出力です (正: 前進, 負: 後進)
+struct DriveOutput {
+  int motor1; // モーター1 (例: 右キャタピラ) の速度 (-255 - 255)
+  int motor2; // モーター2 (例: 左キャタピラ) の速度 (-255 - 255)
+};
+
+/**
+ * @brief スライダー入力を左右のモーター速度に変換するミキサーです。
+ * 中央値128を基準に対称に正規化し、デッドバンド・エクスポ・ミキシング・速度スケールを
+ * すべて整数の固定小数点(Q10, FIXED_ONE = 1.0)で計算します。
+ */
+class DriveMixer {
+public:
+    // --- 固定小数点・デフォルト設定定数 ---
+    static const int FIXED_ONE = 1024;       // 固定小数点の1.0 (Q10)
+    static const int DEFAULT_DEADBAND = 24;  // デッドバンド (約3カウント分のスライダー遊び)
+    static const int DEFAULT_EXPO = 0;       // エクスポ (0: 線形, FIXED_ONE: 3次曲線)
+    static const int SOFT_EXPO = FIXED_ONE / 2; // ソフトエクスポ (スライドスイッチ2で選択、中央付近の微速を出しやすくします)
+    static const int QUICK_TURN_THRESHOLD = FIXED_ONE / 4; // カーブミキサーで超信地旋回を混ぜる前後入力の上限
+
+    /**
+     * @brief DriveMixerクラスのコンストラクタです。
+     * タンクミキサー、デフォルトのデッドバンド・エクスポ、速度スケール1.0で初期化します。
+     */
+    DriveMixer();
+
+    /**
+     * @brief ミキサーの種類を設定します。
+     * @param mode [in] ミキサーの種類。範囲外の場合はMIX_TANKになります。
+     */
+    void setMode(MixMode mode);
+
+    /**
+     * @brief 現在のミキサーの種類を返します。
+     * @return MixMode ミキサーの種類です。
+     */
+    MixMode getMode() const;
+
+    /**
+     * @brief デッドバンドを設定します。
+     * @param deadband [in] デッドバンド (Q10, 0 - FIXED_ONE/2)。
+     */
+    void setDeadband(int deadband);
+
+    /**
+     * @brief エクスポを設定します。
+     * @param expo [in] 3次曲線の混合率 (Q10, 0 - FIXED_ONE)。
+     */
+    void setExpo(int expo);
+
+    /**
+     * @brief 出力の速度スケールを設定します (速度ギア用)。
+     * @param scale [in] 速度スケール (Q10, 0 - FIXED_ONE)。
+     */
+    void setSpeedScale(int scale);
+
+    /**
+     * @brief 前後反転走行を設定します。
+     * @param reversed [in] trueの場合、左右の出力を入れ替えて方向を反転します。
+     */
+    void setReversed(bool reversed);
+
+    /**
+     * @brief スライダー値からモーター速度を計算します。
+     * @param slideVal1 [in] スライダー1の値 (0-255)。
+     * @param slideVal2 [in] スライダー2の値 (0-255)。
+     * @return DriveOutput 左右のモーター速度 (-255 - 255)。
+     */
+    DriveOutput mix(int slideVal1, int slideVal2) const;
+
+    /**
+     * @brief スライダー値(0-255)を中央値128を0とする固定小数点値に正規化します。
+     * 0と1はどちらも-FIXED_ONEになり、正負で対称な範囲になります。
+     * @param slideVal [in] スライダー値 (0-255)。
+     * @return int 正規化した値 (-FIXED_ONE - FIXED_ONE)。
+     */
+    static int normalizeSlider(int slideVal);
+
+private:
+    MixMode _mode;     // ミキサーの種類
+    int _deadband;     // デッドバンド (Q10)
+    int _expo;         // エクスポ (Q10)
+    int _speedScale;   // 速度スケール (Q10)
+    bool _reversed;    // 前後反転走行
+
+    // --- プライベートヘルパー関数 ---
+    int _shapeInput(int value) const;
+};
+
+#endif // DRIVEMIXER_H
@@ -0,0 +1,400 @@
+#include "ESPNowOta.h"
+#include <esp32/rom/crc.h>
+
+// キューやウィンドウを大きくした場合に、RAM使用量が想定を超えていないかをビルド時に確認します
+static_assert(ESPNowOta::TOTAL_RAM_BYTES <= ESPNowOta::RAM_BUDGET_BYTES, "ESPNowOta RAM usage exceeds RAM_BUDGET_BYTES");
+
+/**
+ * @brief ESPNowOtaクラスのコンストラクタです。
+ * 状態を待機中(OTA_STATUS_IDLE)で初期化します。
+ */
+ESPNowOta::ESPNowOta()
+    : _queue(nullptr), _beginCallback(nullptr), _status(OTA_STATUS_IDLE), _senderMac{0},
+      _chunkCount(0), _imageSize(0), _imageCrc32(0), _nextSeq(0),
+      _lastFrameMillis(0), _lastAckMillis(0),
+      _partition(nullptr), _otaHandle(0), _dict(nullptr), _dictOffset(0),
+      _written(0), _crc32(0), _inflateDone(false) {}
+
+/**
+ * @brief 受信フレーム用のキューを作成します。
+ * @return bool 作成に成功した場合はtrue、失敗した場合はfalseを返します。
+ */
+bool ESPNowOta::init() {
+    _queue = xQueueCreate(QUEUE_DEPTH, sizeof(QueuedFrame));
+    if (_queue == nullptr) {
+        Serial.println("OTA queue creation failed");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 転送開始時、フラッシュ消去の直前に呼ばれる関数を登録します。
+ * @param callback [in] 呼び出す関数です (nullptrで解除)。
+ */
+void ESPNowOta::setBeginCallback(BeginCallback callback) {
+    _beginCallback = callback;
+}
+
+/**
+ * @brief 受信データがOTAフレームかどうかを判定します。
+ * 制御パケット(ReceivedDataPacket)とはサイズと先頭のマジック値で区別します。
+ * @param data [in] 受信した生データへのポインタです。
+ * @param len [in] 受信したデータの長さ（バイト数）です。
+ * @return bool OTAフレームであればtrueを返します。
+ */
+bool ESPNowOta::isOtaFrame(const uint8_t *data, int len) const {
+    return len >= (int)sizeof(OtaControlFrame) && len != (int)sizeof(ReceivedDataPacket) &&
+           data[0] == OTA_FRAME_MAGIC;
+}
+
+/**
+ * @brief 受信したOTAフレームをキューに積みます。ESP-NOWの受信コールバックから呼び出します。
+ * @param mac_addr [in] 送信元のMACアドレスです。
+ * @param data [in] 受信した生データへのポインタです。
+ * @param len [in] 受信したデータの長さ（バイト数）です。
+ * @return bool キューに積めた場合はtrue、キューが満杯の場合はfalseを返します。
+ */
+bool ESPNowOta::enqueueFrame(const uint8_t *mac_addr, const uint8_t *data, int len) {
+    if (_queue == nullptr || len > ESP_NOW_MAX_DATA_LEN) {
+        return false;
+    }
+    QueuedFrame frame;
+    memcpy(frame.mac, mac_addr, 6);
+    frame.len = (uint8_t)len;
+    memcpy(frame.data, data, len);
+    // 満杯の場合は待たずに破棄します (欠落はACKのビットマップで再送要求されます)
+    return xQueueSend(_queue, &frame, 0) == pdTRUE;
+}
+
+/**
+ * @brief キューに溜まったフレームを処理します。loop()から定期的に呼び出してください。
+ */
+void ESPNowOta::process() {
+    if (_queue == nullptr) {
+        return;
+    }
+
+    QueuedFrame frame;
+    while (xQueueReceive(_queue, &frame, 0) == pdTRUE) {
+        // 転送中は開始した送信元以外のフレームを無視します
+        if (_status == OTA_STATUS_RECEIVING && memcmp(frame.mac, _senderMac, 6) != 0) {
+            continue;
+        }
+        _lastFrameMillis = millis();
+
+        switch (frame.data[1]) {
+        case OTA_FRAME_BEGIN:
+            if (frame.len == sizeof(OtaBeginFrame)) {
+                OtaBeginFrame begin;
+                memcpy(&begin, frame.data, sizeof(begin));
+                _handleBegin(frame.mac, begin);
+            }
+            break;
+        case OTA_FRAME_DATA:
+            // データフレームは常に最大長で送る決まりです (短いフレームは制御パケットと区別できなくなるため受け付けません)
+            if (_status == OTA_STATUS_RECEIVING && frame.len == sizeof(OtaDataFrame)) {
+                OtaDataFrame data;
+                memcpy(&data, frame.data, sizeof(data));
+                if (data.length > 0 && data.length <= OTA_CHUNK_PAYLOAD_SIZE) {
+                    _handleData(data);
+                }
+            }
+            break;
+        case OTA_FRAME_END:
+            if (_status == OTA_STATUS_RECEIVING) {
+                _handleEnd();
+            }
+            break;
+        case OTA_FRAME_ABORT:
+            if (_status == OTA_STATUS_RECEIVING) {
+                _fail("aborted by sender");
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (_status == OTA_STATUS_RECEIVING) {
+        unsigned long now = millis();
+        if (now - _lastFrameMillis >= SESSION_TIMEOUT_MS) {
+            _fail("session timeout");
+        } else if (now - _lastAckMillis >= ACK_INTERVAL_MS) {
+            // 送信が途切れた場合でも送信側が欠落チャンクを把握できるよう定期的にACKを送ります
+            _sendAck();
+        }
+    }
+}
+
+/**
+ * @brief OTA転送中かどうかを返します。
+ * @return bool 転送中であればtrueを返します。
+ */
+bool ESPNowOta::isActive() const {
+    return _status == OTA_STATUS_RECEIVING;
+}
+
+/**
+ * @brief 転送の進捗を返します。
+ * @return int 進捗率 (0-100)。
+ */
+int ESPNowOta::getProgress() const {
+    if (_chunkCount == 0) {
+        return 0;
+    }
+    return (int)((uint32_t)_nextSeq * 100 / _chunkCount);
+}
+
+/**
+ * @brief 転送開始フレームを処理します。
+ * 書き込み先パーティションの確保と展開器の初期化を行います。
+ * @param mac_addr [in] 送信元のMACアドレスです。
+ * @param frame [in] 転送開始フレームです。
+ */
+void ESPNowOta::_handleBegin(const uint8_t *mac_addr, const OtaBeginFrame &frame) {
+    // 転送中は開始した送信元からのフレームしか届きません (process()で除外します)。
+    // 同じイメージのBEGINは再送や遅れて届いた重複なので、受信済みのチャンクに関係なくACKを返すだけにします
+    if (_status == OTA_STATUS_RECEIVING) {
+        if (_chunkCount == frame.chunkCount && _imageSize == frame.imageSize && _imageCrc32 == frame.imageCrc32) {
+            _sendAck();
+            return;
+        }
+        // 別のイメージのBEGINは送信側がやり直したものとして、現在の転送を破棄して始め直します
+        _releaseSession();
+        _status = OTA_STATUS_IDLE;
+    }
+
+    memcpy(_senderMac, mac_addr, 6);
+    // ACKを返せるよう、送信元がピア登録済みであることを確認します
+    if (!esp_now_is_peer_exist(_senderMac)) {
+        Serial.println("OTA begin from unknown peer ignored");
+        return;
+    }
+    if (frame.chunkCount == 0 || frame.imageSize == 0) {
+        _fail("invalid begin frame");
+        return;
+    }
+
+    _partition = esp_ota_get_next_update_partition(nullptr);
+    if (_partition == nullptr || frame.imageSize > _partition->size) {
+        _fail("no suitable OTA partition");
+        return;
+    }
+
+    _dict = (uint8_t *)malloc(DICT_RAM_BYTES);
+    if (_dict == nullptr) {
+        _fail("out of memory");
+        return;
+    }
+
+    Serial.printf("OTA begin: %u chunks, %u -> %u bytes\n",
+                  frame.chunkCount, frame.compressedSize, frame.imageSize);
+    // 消去中は制御処理が止まるため、最後の出力のまま走り続けないよう先にモーターを止めてもらいます
+    if (_beginCallback != nullptr) {
+        _beginCallback();
+    }
+    // imageSizeを渡して必要な範囲だけを消去します (消去中はloopがブロックされます)
+    esp_err_t err = esp_ota_begin(_partition, frame.imageSize, &_otaHandle);
+    if (err != ESP_OK) {
+        _otaHandle = 0;
+        _fail("esp_ota_begin failed");
+        return;
+    }
+
+    _chunkCount = frame.chunkCount;
+    _imageSize = frame.imageSize;
+    _imageCrc32 = frame.imageCrc32;
+    _nextSeq = 0;
+    for (int i = 0; i < WINDOW_SIZE; i++) {
+        _window[i].valid = false;
+    }
+    tinfl_init(&_inflator);
+    _dictOffset = 0;
+    _written = 0;
+    _crc32 = 0;
+    _inflateDone = false;
+    _status = OTA_STATUS_RECEIVING;
+    _lastFrameMillis = millis();
+    _sendAck();
+}
+
+/**
+ * @brief 圧縮データチャンクフレームを処理します。
+ * ウィンドウ内のチャンクを保持し、順番が揃った分から展開・書き込みを行います。
+ * @param frame [in] 圧縮データチャンクフレームです。
+ */
+void ESPNowOta::_handleData(const OtaDataFrame &frame) {
+    uint16_t seq = frame.seq;
+    if (seq >= _chunkCount) {
+        return;
+    }
+    if (seq < _nextSeq) {
+        // 受信済みチャンクの再送はACKが届かなかったことを意味するため、すぐにACKを返します
+        _sendAck();
+        return;
+    }
+    if (seq >= _nextSeq + WINDOW_SIZE) {
+        // ウィンドウ外のチャンクは破棄します (後で再送されます)
+        return;
+    }
+
+    ChunkSlot &slot = _window[seq % WINDOW_SIZE];
+    if (!slot.valid) {
+        slot.valid = true;
+        slot.length = frame.length;
+        memcpy(slot.payload, frame.payload, frame.length);
+    }
+
+    // 順番が揃ったチャンクを展開して書き込みます
+    uint16_t startSeq = _nextSeq;
+    while (_nextSeq < _chunkCount && _window[_nextSeq % WINDOW_SIZE].valid) {
+        ChunkSlot &ready = _window[_nextSeq % WINDOW_SIZE];
+        bool isLast = (_nextSeq == _chunkCount - 1);
+        if (!_inflateChunk(ready.payload, ready.length, isLast)) {
+            return;
+        }
+        ready.valid = false;
+        _nextSeq++;
+    }
+
+    // ウィンドウの半分進むごと、または最後のチャンクまで揃ったらACKを返します
+    if (_nextSeq / (WINDOW_SIZE / 2) != startSeq / (WINDOW_SIZE / 2) || _nextSeq == _chunkCount) {
+        _sendAck();
+    }
+}
+
+/**
+ * @brief 転送終了フレームを処理します。
+ * すべてのチャンクが揃っていればイメージを検証し、起動パーティションを切り替えて再起動します。
+ */
+void ESPNowOta::_handleEnd() {
+    if (_nextSeq < _chunkCount) {
+        // まだ欠落があるため、ACKで再送を要求します
+        _sendAck();
+        return;
+    }
+    if (!_inflateDone || _written != _imageSize) {
+        _fail("image size mismatch");
+        return;
+    }
+    if (_crc32 != _imageCrc32) {
+        _fail("CRC mismatch");
+        return;
+    }
+
+    // esp_ota_end()でイメージヘッダとSHA-256の検証も行われます
+    esp_err_t err = esp_ota_end(_otaHandle);
+    _otaHandle = 0;
+    if (err != ESP_OK) {
+        _fail("image validation failed");
+        return;
+    }
+    if (esp_ota_set_boot_partition(_partition) != ESP_OK) {
+        _fail("esp_ota_set_boot_partition failed");
+        return;
+    }
+
+    Serial.println("OTA update successful. Restarting...");
+    _status = OTA_STATUS_SUCCESS;
+    _sendAck();
+    _releaseSession();
+    delay(500); // ACKの送信完了を待ちます
+    ESP.restart();
+}
+
+/**
+ * @brief 1チャンク分の圧縮データを展開し、OTAパーティションへ書き込みます。
+ * 展開結果は辞書バッファ(循環バッファ)に出力され、出力された範囲をそのまま書き込みます。
+ * @param payload [in] 圧縮データへのポインタです。
+ * @param length [in] 圧縮データのバイト数です。
+ * @param isLast [in] 最後のチャンクであればtrueです。
+ * @return bool 成功した場合はtrue、エラーで転送を中止した場合はfalseを返します。
+ */
+bool ESPNowOta::_inflateChunk(const uint8_t *payload, size_t length, bool isLast) {
+    const mz_uint32 flags = TINFL_FLAG_PARSE_ZLIB_HEADER | (isLast ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+    const uint8_t *in = payload;
+    size_t inRemaining = length;
+
+    while (!_inflateDone) {
+        size_t inBytes = inRemaining;
+        size_t outBytes = TINFL_LZ_DICT_SIZE - _dictOffset;
+        tinfl_status status = tinfl_decompress(&_inflator, in, &inBytes,
+                                               _dict, _dict + _dictOffset, &outBytes, flags);
+        in += inBytes;
+        inRemaining -= inBytes;
+
+        if (outBytes > 0) {
+            if (_written + outBytes > _imageSize) {
+                _fail("image larger than announced");
+                return false;
+            }
+            if (esp_ota_write(_otaHandle, _dict + _dictOffset, outBytes) != ESP_OK) {
+                _fail("esp_ota_write failed");
+                return false;
+            }
+            _crc32 = crc32_le(_crc32, _dict + _dictOffset, outBytes);
+            _written += outBytes;
+            _dictOffset = (_dictOffset + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+
+        if (status < TINFL_STATUS_DONE) {
+            _fail("decompression error");
+            return false;
+        }
+        if (status == TINFL_STATUS_DONE) {
+            _inflateDone = true;
+        } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT) {
+            break;
+        }
+        // TINFL_STATUS_HAS_MORE_OUTPUTの場合は辞書バッファを進めて続けます
+    }
+    return true;
+}
+
+/**
+ * @brief 現在の受信状況をACKフレームで送信元に通知します。
+ */
+void ESPNowOta::_sendAck() {
+    OtaAckFrame ack;
+    ack.magic = OTA_FRAME_MAGIC;
+    ack.type = OTA_FRAME_ACK;
+    ack.status = _status;
+    ack.nextSeq = _nextSeq;
+    ack.receivedBitmap = 0;
+    for (int i = 0; i < WINDOW_SIZE; i++) {
+        uint32_t seq = (uint32_t)_nextSeq + i;
+        if (seq < _chunkCount && _window[seq % WINDOW_SIZE].valid) {
+            ack.receivedBitmap |= (1UL << i);
+        }
+    }
+    esp_now_send(_senderMac, (uint8_t *)&ack, sizeof(ack));
+    _lastAckMillis = millis();
+}
+
+/**
+ * @brief エラー発生時に転送を中止し、送信元へエラーを通知します。
+ * @param reason [in] エラー内容 (シリアル出力用)。
+ */
+void ESPNowOta::_fail(const char *reason) {
+    Serial.printf("OTA failed: %s\n", reason);
+    _status = OTA_STATUS_ERROR;
+    _sendAck();
+    _releaseSession();
+    _status = OTA_STATUS_IDLE;
+}
+
+/**
+ * @brief 転送セッションで確保したリソースを解放します。
+ */
+void ESPNowOta::_releaseSession() {
+    if (_otaHandle != 0) {
+        esp_ota_abort(_otaHandle);
+        _otaHandle = 0;
+    }
+    if (_dict != nullptr) {
+        free(_dict);
+        _dict = nullptr;
+    }
+    _chunkCount = 0;
+}
@@ -0,0 +1,145 @@
+#ifndef ESPNOWOTA_H
+#define ESPNOWOTA_H
+
+#include <Arduino.h>
+#include <esp_now.h>
+#include <esp_ota_ops.h>
+#include <esp32/rom/miniz.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "DataStructures.h"
+
+/**
+ * @brief ESP-NOW経由でファームウェアを受信し、OTA更新を行うクラスです。
+ * zlib圧縮されたイメージを小さなフレームで受け取り、ウィンドウ単位の確認応答と
+ * 欠落チャンクの再送要求を行います。受信したデータは逐次展開して非アクティブな
+ * OTAパーティションへ書き込むため、イメージ全体をRAMに保持しません。
+ * @note 受信コールバックはWi-Fiタスク上で呼ばれるため、フレームはキューに積むだけにし、
+ *       展開とフラッシュ書き込みはprocess()内(loop側)で行います。
+ */
+class ESPNowOta {
+public:
+    // 転送開始時(フラッシュ消去の直前)に呼ばれる関数の型です
+    typedef void (*BeginCallback)();
+
+    // --- OTA設定定数 ---
+    static const int WINDOW_SIZE = 16;          // 順序待ちで保持できるチャンク数 (ACKビットマップは最大32)
+    static const int QUEUE_DEPTH = 24;          // 受信コールバックからのフレームキューの深さ
+    static const int ACK_INTERVAL_MS = 100;     // 受信中に定期的にACKを送る間隔
+    static const int SESSION_TIMEOUT_MS = 5000; // この時間フレームが届かなければ転送を中止します
+
+    /**
+     * @brief ESPNowOtaクラスのコンストラクタです。
+     * 状態を待機中(OTA_STATUS_IDLE)で初期化します。
+     */
+    ESPNowOta();
+
+    /**
+     * @brief 受信フレーム用のキューを作成します。
+     * @return bool 作成に成功した場合はtrue、失敗した場合はfalseを返します。
+     * @note ESP-NOWの受信コールバックを登録する前に呼び出してください。
+     */
+    bool init();
+
+    /**
+     * @brief 転送開始時、フラッシュ消去の直前に呼ばれる関数を登録します。
+     * 消去の間(数秒)はloopがブロックされるため、この関数でモーターとブザーを止めてください。
+     * @param callback [in] 呼び出す関数です (nullptrで解除)。
+     */
+    void setBeginCallback(BeginCallback callback);
+
+    /**
+     * @brief 受信データがOTAフレームかどうかを判定します。
+     * @param data [in] 受信した生データへのポインタです。
+     * @param len [in] 受信したデータの長さ（バイト数）です。
+     * @return bool OTAフレームであればtrueを返します。
+     */
+    bool isOtaFrame(const uint8_t *data, int len) const;
+
+    /**
+     * @brief 受信したOTAフレームをキューに積みます。ESP-NOWの受信コールバックから呼び出します。
+     * @param mac_addr [in] 送信元のMACアドレスです。
+     * @param data [in] 受信した生データへのポインタです。
+     * @param len [in] 受信したデータの長さ（バイト数）です。
+     * @return bool キューに積めた場合はtrue、キューが満杯の場合はfalseを返します (送信側の再送で回復します)。
+     */
+    bool enqueueFrame(const uint8_t *mac_addr, const uint8_t *data, int len);
+
+    /**
+     * @brief キューに溜まったフレームを処理します。loop()から定期的に呼び出してください。
+     * 展開・フラッシュ書き込み・ACK送信・タイムアウト判定を行い、検証に成功すると再起動します。
+     */
+    void process();
+
+    /**
+     * @brief OTA転送中かどうかを返します。
+     * @return bool 転送中であればtrueを返します。転送中はモーターを停止させてください。
+     */
+    bool isActive() const;
+
+    /**
+     * @brief 転送の進捗を返します。
+     * @return int 進捗率 (0-100)。
+     */
+    int getProgress() const;
+
+private:
+    // キューに積む受信フレームです
+    struct QueuedFrame {
+        uint8_t mac[6];
+        uint8_t len;
+        uint8_t data[ESP_NOW_MAX_DATA_LEN];
+    };
+
+    // 順序待ちのチャンクを保持するスロットです
+    struct ChunkSlot {
+        bool valid;
+        uint8_t length;
+        uint8_t payload[OTA_CHUNK_PAYLOAD_SIZE];
+    };
+
+public:
+    // --- RAM使用量 (バイト) ---
+    static const size_t QUEUE_RAM_BYTES = QUEUE_DEPTH * sizeof(QueuedFrame);  // 受信フレームキュー (init()でヒープに確保)
+    static const size_t WINDOW_RAM_BYTES = WINDOW_SIZE * sizeof(ChunkSlot);   // 順序待ちウィンドウ (メンバー)
+    static const size_t INFLATOR_RAM_BYTES = sizeof(tinfl_decompressor);     // 展開器 (メンバー)
+    static const size_t DICT_RAM_BYTES = TINFL_LZ_DICT_SIZE;                 // 展開用辞書 (転送中のみヒープに確保)
+    static const size_t TOTAL_RAM_BYTES = QUEUE_RAM_BYTES + WINDOW_RAM_BYTES + INFLATOR_RAM_BYTES + DICT_RAM_BYTES;
+    static const size_t RAM_BUDGET_BYTES = 56 * 1024;                        // TOTAL_RAM_BYTESの上限 (ESPNowOta.cppで確認します)
+
+private:
+    QueueHandle_t _queue;                   // 受信フレームキュー
+    BeginCallback _beginCallback;           // フラッシュ消去の直前に呼ぶ関数
+    OtaStatus _status;                      // 現在の状態
+    uint8_t _senderMac[6];                  // 転送元のMACアドレス
+
+    // --- 転送セッション情報 ---
+    uint16_t _chunkCount;                   // チャンク総数
+    uint32_t _imageSize;                    // 展開後のイメージサイズ
+    uint32_t _imageCrc32;                   // 展開後のイメージのCRC32
+    uint16_t _nextSeq;                      // 次に展開するチャンク番号
+    ChunkSlot _window[WINDOW_SIZE];         // 順序待ちウィンドウ
+    unsigned long _lastFrameMillis;         // 最後にフレームを受信した時刻
+    unsigned long _lastAckMillis;           // 最後にACKを送信した時刻
+
+    // --- 展開・書き込み ---
+    const esp_partition_t *_partition;      // 書き込み先のOTAパーティション
+    esp_ota_handle_t _otaHandle;            // OTA書き込みハンドル
+    tinfl_decompressor _inflator;           // miniz(ROM)の展開器
+    uint8_t *_dict;                         // 展開用の辞書バッファ (TINFL_LZ_DICT_SIZE)
+    size_t _dictOffset;                     // 辞書バッファ内の書き込み位置
+    uint32_t _written;                      // 書き込み済みバイト数
+    uint32_t _crc32;                        // 書き込み済みデータのCRC32
+    bool _inflateDone;                      // 圧縮ストリームの終端に達したか
+
+    // --- プライベートヘルパー関数 ---
+    void _handleBegin(const uint8_t *mac_addr, const OtaBeginFrame &frame);
+    void _handleData(const OtaDataFrame &frame);
+    void _handleEnd();
+    bool _inflateChunk(const uint8_t *payload, size_t length, bool isLast);
+    void _sendAck();
+    void _fail(const char *reason);
+    void _releaseSession();
+};
+
+#endif // ESPNOWOTA_H
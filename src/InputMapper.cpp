@@ -0,0 +1,178 @@
+#include "InputMapper.h"
+
+// --- 入力マッピングテーブル ---
+// スイッチの割り当てを変更する場合はこのテーブルを編集してください。
+// 割り当てのないスイッチ(SW6-8, スライドスイッチ3-4)もgetHeld()等で参照できます。
+static constexpr InputMapping INPUT_MAPPINGS[] = {
+  {INPUT_SW1,       TRIGGER_PRESS,   ACTION_HORN_ON},        // SW1を押している間ブザーを鳴らします
+  {INPUT_SW1,       TRIGGER_RELEASE, ACTION_HORN_OFF},
+  {INPUT_SW2,       TRIGGER_PRESS,   ACTION_LIGHTS_TOGGLE},  // SW2でライトを切り替えます
+  {INPUT_SW3,       TRIGGER_PRESS,   ACTION_GEAR_UP},        // SW3で速度ギアを上げます
+  {INPUT_SW4,       TRIGGER_PRESS,   ACTION_GEAR_DOWN},      // SW4で速度ギアを下げます
+  {INPUT_SLD_SW1_2, TRIGGER_ON,      ACTION_DRIVE_REVERSED}, // スライドスイッチ1の位置で前後反転走行を決めます
+  {INPUT_SLD_SW1_2, TRIGGER_OFF,     ACTION_DRIVE_NORMAL},
+  {INPUT_SW5,       TRIGGER_PRESS,   ACTION_MIX_MODE_NEXT},  // SW5でミキサーを切り替えます
+  {INPUT_SLD_SW2_2, TRIGGER_ON,      ACTION_EXPO_SOFT},      // スライドスイッチ2の位置でスライダーの応答を決めます
+  {INPUT_SLD_SW2_2, TRIGGER_OFF,     ACTION_EXPO_LINEAR},
+};
+
+/**
+ * @brief InputMapperクラスのコンストラクタです。
+ * 全スイッチOFF、ライト消灯、最高速ギア、通常走行モード、タンクミキサー、線形応答で初期化します。
+ */
+InputMapper::InputMapper()
+    : _held(0), _pressed(0), _released(0),
+      _state{false, false, SPEED_GEAR_COUNT, DRIVE_MODE_NORMAL, MIX_TANK, false} {}
+
+/**
+ * @brief 受信データのスイッチ状態を16bitのビットマスクにまとめます。
+ * @param packet [in] 受信データです。
+ * @return uint16_t ONのスイッチのビットが1になったマスク (ビット位置はInputBit)。
+ */
+uint16_t InputMapper::packSwitches(const ReceivedDataPacket &packet) {
+    // アクティブローのため、0のときにビットを立てます
+    return (uint16_t)(((packet.sw1 == 0) << INPUT_SW1) |
+                      ((packet.sw2 == 0) << INPUT_SW2) |
+                      ((packet.sw3 == 0) << INPUT_SW3) |
+                      ((packet.sw4 == 0) << INPUT_SW4) |
+                      ((packet.sw5 == 0) << INPUT_SW5) |
+                      ((packet.sw6 == 0) << INPUT_SW6) |
+                      ((packet.sw7 == 0) << INPUT_SW7) |
+                      ((packet.sw8 == 0) << INPUT_SW8) |
+                      ((packet.sld_sw1_1 == 0) << INPUT_SLD_SW1_1) |
+                      ((packet.sld_sw1_2 == 0) << INPUT_SLD_SW1_2) |
+                      ((packet.sld_sw2_1 == 0) << INPUT_SLD_SW2_1) |
+                      ((packet.sld_sw2_2 == 0) << INPUT_SLD_SW2_2) |
+                      ((packet.sld_sw3_1 == 0) << INPUT_SLD_SW3_1) |
+                      ((packet.sld_sw3_2 == 0) << INPUT_SLD_SW3_2) |
+                      ((packet.sld_sw4_1 == 0) << INPUT_SLD_SW4_1) |
+                      ((packet.sld_sw4_2 == 0) << INPUT_SLD_SW4_2));
+}
+
+/**
+ * @brief 新しく受信したデータでスイッチ状態を更新し、エッジ・レベルに対応するアクションを実行します。
+ * @param packet [in] 受信データです。
+ */
+void InputMapper::update(const ReceivedDataPacket &packet) {
+    uint16_t current = packSwitches(packet);
+    uint16_t changed = current ^ _held; // 変化したスイッチ
+    _pressed = changed & current;
+    _released = changed & _held;
+    _held = current;
+
+    // レベルの割り当ては変化がなくても毎回評価するため、テーブルは常に全体を走査します
+    for (const InputMapping &mapping : INPUT_MAPPINGS) {
+        uint16_t bits;
+        switch (mapping.trigger) {
+        case TRIGGER_PRESS:
+            bits = _pressed;
+            break;
+        case TRIGGER_RELEASE:
+            bits = _released;
+            break;
+        case TRIGGER_ON:
+            bits = _held;
+            break;
+        case TRIGGER_OFF:
+        default:
+            bits = (uint16_t)~_held;
+            break;
+        }
+        if (bits & (1u << mapping.bit)) {
+            _dispatch(mapping.action);
+        }
+    }
+}
+
+/**
+ * @brief ブザーを止め、直前のエッジを消去します。通信ロス時に呼び出します。
+ * _heldは保持し、復帰後のupdate()では途絶中に実際に変化したスイッチだけをエッジとして扱います。
+ */
+void InputMapper::reset() {
+    _pressed = 0;
+    _released = 0;
+    _state.horn = false;
+}
+
+/**
+ * @brief 現在ONになっているスイッチのビットマスクを返します。
+ * @return uint16_t ビットマスク (ビット位置はInputBit)。
+ */
+uint16_t InputMapper::getHeld() const {
+    return _held;
+}
+
+/**
+ * @brief 直前のupdate()で押下されたスイッチのビットマスクを返します。
+ * @return uint16_t ビットマスク (ビット位置はInputBit)。
+ */
+uint16_t InputMapper::getPressed() const {
+    return _pressed;
+}
+
+/**
+ * @brief 直前のupdate()で解放されたスイッチのビットマスクを返します。
+ * @return uint16_t ビットマスク (ビット位置はInputBit)。
+ */
+uint16_t InputMapper::getReleased() const {
+    return _released;
+}
+
+/**
+ * @brief 現在の操縦状態を返します。
+ * @return const ControlState& 操縦状態です。
+ */
+const ControlState &InputMapper::getState() const {
+    return _state;
+}
+
+/**
+ * @brief 現在の速度ギアに対応する速度スケールを返します。
+ * @return int 速度スケール (Q10, DriveMixer::FIXED_ONEが最高速)。
+ */
+int InputMapper::getSpeedScale() const {
+    return _state.speedGear * DriveMixer::FIXED_ONE / SPEED_GEAR_COUNT;
+}
+
+/**
+ * @brief アクションを実行して操縦状態を更新します。
+ * @param action [in] 実行するアクションです。
+ */
+void InputMapper::_dispatch(InputAction action) {
+    switch (action) {
+    case ACTION_HORN_ON:
+        _state.horn = true;
+        break;
+    case ACTION_HORN_OFF:
+        _state.horn = false;
+        break;
+    case ACTION_LIGHTS_TOGGLE:
+        _state.lights = !_state.lights;
+        break;
+    case ACTION_GEAR_UP:
+        if (_state.speedGear < SPEED_GEAR_COUNT) {
+            _state.speedGear++;
+        }
+        break;
+    case ACTION_GEAR_DOWN:
+        if (_state.speedGear > 1) {
+            _state.speedGear--;
+        }
+        break;
+    case ACTION_DRIVE_NORMAL:
+        _state.driveMode = DRIVE_MODE_NORMAL;
+        break;
+    case ACTION_DRIVE_REVERSED:
+        _state.driveMode = DRIVE_MODE_REVERSED;
+        break;
+    case ACTION_MIX_MODE_NEXT:
+        _state.mixMode = (MixMode)((_state.mixMode + 1) % MIX_MODE_COUNT);
+        break;
+    case ACTION_EXPO_LINEAR:
+        _state.softExpo = false;
+        break;
+    case ACTION_EXPO_SOFT:
+        _state.softExpo = true;
+        break;
+    }
+}
@@ -0,0 +1,145 @@
+#ifndef INPUTMAPPER_H
+#define INPUTMAPPER_H
+
+#include <Arduino.h>
+#include "DataStructures.h"
+#include "DriveMixer.h"
+
+// --- スイッチのビット位置定義 ---
+// 受信したスイッチ状態を16bitのビットマスクにまとめる際のビット位置です。
+// スイッチはすべてアクティブロー (0で押下/ON) として扱い、ONのときビットが1になります。
+enum InputBit : uint8_t {
+  INPUT_SW1 = 0, INPUT_SW2, INPUT_SW3, INPUT_SW4,          // ボタンスイッチ1-4
+  INPUT_SW5, INPUT_SW6, INPUT_SW7, INPUT_SW8,              // ボタンスイッチ5-8
+  INPUT_SLD_SW1_1, INPUT_SLD_SW1_2,                        // スライドスイッチ1
+  INPUT_SLD_SW2_1, INPUT_SLD_SW2_2,                        // スライドスイッチ2
+  INPUT_SLD_SW3_1, INPUT_SLD_SW3_2,                        // スライドスイッチ3
+  INPUT_SLD_SW4_1, INPUT_SLD_SW4_2,                        // スライドスイッチ4
+};
+
+// アクションを発火させる条件です
+enum InputTrigger : uint8_t {
+  TRIGGER_PRESS = 0,   // OFF -> ON のエッジ
+  TRIGGER_RELEASE,     // ON -> OFF のエッジ
+  TRIGGER_ON,          // ONの間、update()ごと (スライドスイッチなど位置で状態が決まるもの)
+  TRIGGER_OFF,         // OFFの間、update()ごと
+};
+
+// スイッチに割り当てるアクションです
+enum InputAction : uint8_t {
+  ACTION_HORN_ON,          // ブザーを鳴らす
+  ACTION_HORN_OFF,         // ブザーを止める
+  ACTION_LIGHTS_TOGGLE,    // ライト(白色LED)の点灯/消灯を切り替える
+  ACTION_GEAR_UP,          // 速度ギアを1段上げる
+  ACTION_GEAR_DOWN,        // 速度ギアを1段下げる
+  ACTION_DRIVE_NORMAL,     // 通常走行モードにする
+  ACTION_DRIVE_REVERSED,   // 前後反転走行モードにする
+  ACTION_MIX_MODE_NEXT,    // ミキサー(タンク/アーケード/カーブ)を順に切り替える
+  ACTION_EXPO_LINEAR,      // スライダーの応答を線形にする
+  ACTION_EXPO_SOFT,        // スライダーの応答をソフトエクスポにする (中央付近を緩やかに)
+};
+
+// 走行モードです
+enum DriveMode : uint8_t {
+  DRIVE_MODE_NORMAL = 0,   // 前を前として操縦する
+  DRIVE_MODE_REVERSED,     // 後ろを前として操縦する (左右のモーターを入れ替え、方向を反転)
+};
+
+// 入力マッピングテーブルの1エントリです
+struct InputMapping {
+  InputBit bit;         // 対象のスイッチ
+  InputTrigger trigger; // 発火する条件
+  InputAction action;   // 実行するアクション
+};
+
+// 入力から決まる操縦状態です
+struct ControlState {
+  bool horn;           // ブザーを鳴らしているか
+  bool lights;         // ライトを点灯しているか
+  int speedGear;       // 速度ギア (1 - InputMapper::SPEED_GEAR_COUNT)
+  DriveMode driveMode; // 走行モード
+  MixMode mixMode;     // ミキサーの種類
+  bool softExpo;       // スライダーの応答にソフトエクスポを使うか (falseで線形)
+};
+
+/**
+ * @brief 受信したスイッチ入力をアクションに割り当てるクラスです。
+ * スイッチ状態をビットマスクにまとめ、前回とのXORで押下/解放のエッジを求めて、
+ * constexprのマッピングテーブル(InputMapper.cpp)に従いアクションを実行します。
+ * スライドスイッチのようにON/OFFの位置で状態が決まるものはレベル(TRIGGER_ON/OFF)で割り当て、
+ * 通信ロスでエッジを取りこぼしても次の受信で現在の位置に従うようにします。
+ * 1フレームあたりの処理量はテーブルの長さで決まり、入力の組み合わせに依存しません。
+ */
+class InputMapper {
+public:
+    static const int SPEED_GEAR_COUNT = 3; // 速度ギアの段数
+
+    /**
+     * @brief InputMapperクラスのコンストラクタです。
+     * 全スイッチOFF、ライト消灯、最高速ギア、通常走行モード、タンクミキサー、線形応答で初期化します。
+     */
+    InputMapper();
+
+    /**
+     * @brief 受信データのスイッチ状態を16bitのビットマスクにまとめます。
+     * @param packet [in] 受信データです。
+     * @return uint16_t ONのスイッチのビットが1になったマスク (ビット位置はInputBit)。
+     */
+    static uint16_t packSwitches(const ReceivedDataPacket &packet);
+
+    /**
+     * @brief 新しく受信したデータでスイッチ状態を更新し、エッジ・レベルに対応するアクションを実行します。
+     * @param packet [in] 受信データです。
+     * @note 新しいデータを受信したときだけ呼び出してください。
+     */
+    void update(const ReceivedDataPacket &packet);
+
+    /**
+     * @brief ブザーを止め、直前のエッジを消去します。通信ロス時に呼び出します。
+     * 押されているスイッチの状態は保持するため、押したまま復帰しても押下エッジにはならず、
+     * ライト・速度ギア・ミキサーが再び切り替わることはありません (ブザーはSW1を押し直すまで鳴りません)。
+     * 走行モードは次のupdate()でスイッチの位置から決め直します。
+     */
+    void reset();
+
+    /**
+     * @brief 現在ONになっているスイッチのビットマスクを返します。
+     * @return uint16_t ビットマスク (ビット位置はInputBit)。
+     */
+    uint16_t getHeld() const;
+
+    /**
+     * @brief 直前のupdate()で押下されたスイッチのビットマスクを返します。
+     * @return uint16_t ビットマスク (ビット位置はInputBit)。
+     */
+    uint16_t getPressed() const;
+
+    /**
+     * @brief 直前のupdate()で解放されたスイッチのビットマスクを返します。
+     * @return uint16_t ビットマスク (ビット位置はInputBit)。
+     */
+    uint16_t getReleased() const;
+
+    /**
+     * @brief 現在の操縦状態を返します。
+     * @return const ControlState& 操縦状態です。
+     */
+    const ControlState &getState() const;
+
+    /**
+     * @brief 現在の速度ギアに対応する速度スケールを返します。
+     * @return int 速度スケール (Q10, DriveMixer::FIXED_ONEが最高速)。
+     */
+    int getSpeedScale() const;
+
+private:
+    uint16_t _held;      // 現在ONのスイッチ
+    uint16_t _pressed;   // 直前のupdate()での押下エッジ
+    uint16_t _released;  // 直前のupdate()での解放エッジ
+    ControlState _state; // 操縦状態
+
+    // --- プライベートヘルパー関数 ---
+    void _dispatch(InputAction action);
+};
+
+#endif // INPUTMAPPER_H
@@ -0,0 +1,104 @@
+#include "LinkMonitor.h"
+
+/**
+ * @brief LinkMonitorクラスのコンストラクタです。
+ * すべての計測値を0で初期化します。
+ */
+LinkMonitor::LinkMonitor()
+    : _mux(portMUX_INITIALIZER_UNLOCKED), _lastRxMicros(0), _rxPackets(0), _latencyHistogram{0}, _latencyMaxUs(0),
+      _actuations(0), _cpuTotalUs(0), _failsafeTrips(0), _lastCollectMillis(0) {}
+
+/**
+ * @brief 制御パケットの受信時刻を記録します。ESP-NOWの受信コールバックから呼び出します。
+ */
+void LinkMonitor::onPacketReceived() {
+    uint32_t now = micros();
+    // 受信コールバックは別コアのWi-Fiタスクで動くため、collect()の読み出し・クリアと排他にします
+    portENTER_CRITICAL(&_mux);
+    _lastRxMicros = now;
+    _rxPackets++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+/**
+ * @brief 新しいパケットをモーターへ反映したことを記録します。
+ * @param controlMicros [in] 受信データの解釈・入力マッピング・ミキシングにかかった時間 (マイクロ秒)。
+ */
+void LinkMonitor::onActuated(uint32_t controlMicros) {
+    uint32_t now = micros();
+    portENTER_CRITICAL(&_mux);
+    uint32_t lastRxMicros = _lastRxMicros;
+    portEXIT_CRITICAL(&_mux);
+    uint32_t latency = now - lastRxMicros;
+
+    int bucket = latency / LATENCY_BUCKET_US;
+    if (bucket >= LATENCY_BUCKET_COUNT) {
+        bucket = LATENCY_BUCKET_COUNT - 1;
+    }
+    _latencyHistogram[bucket]++;
+    if (latency > _latencyMaxUs) {
+        _latencyMaxUs = latency;
+    }
+    _actuations++;
+    _cpuTotalUs += controlMicros;
+}
+
+/**
+ * @brief 通信ロスによるフェイルセーフの発生を記録します。
+ */
+void LinkMonitor::onFailsafeTrip() {
+    _failsafeTrips++;
+}
+
+/**
+ * @brief 集計間隔が経過していれば統計を集計し、計測値をリセットします。
+ * @param stats [out] 集計した統計です。
+ * @return bool 集計した場合はtrue、集計間隔に達していない場合はfalseを返します。
+ */
+bool LinkMonitor::collect(LinkStats &stats) {
+    unsigned long now = millis();
+    if (now - _lastCollectMillis < REPORT_INTERVAL_MS) {
+        return false;
+    }
+    _lastCollectMillis = now;
+
+    // 受信数の読み出しとクリアの間に受信した分を取りこぼさないよう、まとめて行います
+    portENTER_CRITICAL(&_mux);
+    stats.rxPackets = _rxPackets;
+    _rxPackets = 0;
+    portEXIT_CRITICAL(&_mux);
+    stats.actuations = _actuations;
+    stats.latencyP50Us = _percentile(50);
+    stats.latencyP99Us = _percentile(99);
+    stats.latencyMaxUs = _latencyMaxUs;
+    stats.cpuAvgUs = (_actuations > 0) ? _cpuTotalUs / _actuations : 0;
+    stats.failsafeTrips = _failsafeTrips;
+
+    // 期間ごとの値をリセットします (フェイルセーフ回数は起動からの累計のまま保持します)
+    memset(_latencyHistogram, 0, sizeof(_latencyHistogram));
+    _latencyMaxUs = 0;
+    _actuations = 0;
+    _cpuTotalUs = 0;
+    return true;
+}
+
+/**
+ * @brief 遅延ヒストグラムからパーセンタイルを求めます。
+ * @param percent [in] 求めるパーセンタイル (1-100)。
+ * @return uint32_t 該当バケットの上限値 (マイクロ秒)。記録がない場合は0を返します。
+ */
+uint32_t LinkMonitor::_percentile(int percent) const {
+    if (_actuations == 0) {
+        return 0;
+    }
+    // 切り上げで順位を求め、累積度数がその順位に達したバケットを返します
+    uint32_t rank = (_actuations * percent + 99) / 100;
+    uint32_t cumulative = 0;
+    for (int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        cumulative += _latencyHistogram[i];
+        if (cumulative >= rank) {
+            return (i + 1) * LATENCY_BUCKET_US;
+        }
+    }
+    return LATENCY_BUCKET_COUNT * LATENCY_BUCKET_US;
+}
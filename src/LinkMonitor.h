@@ -0,0 +1,79 @@
+#ifndef LINKMONITOR_H
+#define LINKMONITOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+// 一定期間ごとに集計した通信・制御の統計です
+struct LinkStats {
+  uint32_t rxPackets;       // 期間内に受信した制御パケット数
+  uint32_t actuations;      // 期間内に新しいパケットをモーターへ反映した回数
+  uint32_t latencyP50Us;    // 受信から反映までの遅延の中央値 (マイクロ秒)
+  uint32_t latencyP99Us;    // 受信から反映までの遅延の99パーセンタイル (マイクロ秒)
+  uint32_t latencyMaxUs;    // 受信から反映までの遅延の最大値 (マイクロ秒)
+  uint32_t cpuAvgUs;        // 1パケットあたりの制御処理(解釈・マッピング・ミキシング)時間の平均 (マイクロ秒)
+  uint32_t failsafeTrips;   // 起動からの通信ロス(フェイルセーフ)発生回数
+};
+
+/**
+ * @brief 受信から動作反映までの遅延、フェイルセーフ発生回数、処理時間を計測するクラスです。
+ * 遅延は固定幅のヒストグラムに記録するため、パケット数によらずメモリ使用量と処理量は一定です。
+ * @note onPacketReceived()はESP-NOWの受信コールバック(Wi-Fiタスク)から、それ以外はloop()から呼び出します。
+ *       両者で共有する値はクリティカルセクションで保護します。
+ */
+class LinkMonitor {
+public:
+    // --- 計測設定定数 ---
+    static const int LATENCY_BUCKET_COUNT = 64;       // 遅延ヒストグラムのバケット数
+    static const uint32_t LATENCY_BUCKET_US = 500;    // 1バケットの幅 (最後のバケットは32ms以上をまとめます)
+    static const unsigned long REPORT_INTERVAL_MS = 1000; // 統計を集計する間隔
+
+    /**
+     * @brief LinkMonitorクラスのコンストラクタです。
+     * すべての計測値を0で初期化します。
+     */
+    LinkMonitor();
+
+    /**
+     * @brief 制御パケットの受信時刻を記録します。ESP-NOWの受信コールバックから呼び出します。
+     */
+    void onPacketReceived();
+
+    /**
+     * @brief 新しいパケットをモーターへ反映したことを記録します。
+     * 最後の受信から現在までを遅延として記録します。モーター出力の直後に呼び出してください。
+     * @param controlMicros [in] 受信データの解釈・入力マッピング・ミキシングにかかった時間 (マイクロ秒)。
+     */
+    void onActuated(uint32_t controlMicros);
+
+    /**
+     * @brief 通信ロスによるフェイルセーフの発生を記録します。発生した時点で1回だけ呼び出します。
+     */
+    void onFailsafeTrip();
+
+    /**
+     * @brief 集計間隔が経過していれば統計を集計し、計測値をリセットします。
+     * @param stats [out] 集計した統計です。
+     * @return bool 集計した場合はtrue、集計間隔に達していない場合はfalseを返します。
+     */
+    bool collect(LinkStats &stats);
+
+private:
+    // --- 受信コールバックから更新する値 (_muxで保護します) ---
+    portMUX_TYPE _mux;                     // 受信コールバックとloop()の排他制御用
+    uint32_t _lastRxMicros;                // 最後に受信したときのmicros()
+    uint32_t _rxPackets;                   // 期間内の受信パケット数
+
+    // --- loop()から更新する値 ---
+    uint32_t _latencyHistogram[LATENCY_BUCKET_COUNT]; // 遅延のヒストグラム
+    uint32_t _latencyMaxUs;                // 期間内の遅延の最大値
+    uint32_t _actuations;                  // 期間内の反映回数
+    uint32_t _cpuTotalUs;                  // 期間内の処理時間の合計
+    uint32_t _failsafeTrips;               // 起動からのフェイルセーフ発生回数
+    unsigned long _lastCollectMillis;      // 最後に集計した時刻
+
+    // --- プライベートヘルパー関数 ---
+    uint32_t _percentile(int percent) const;
+};
+
+#endif // LINKMONITOR_H
@@ -0,0 +1,225 @@
+#include "RobotController.h"
+
+/**
+ * @brief RobotControllerクラスのコンストラクタです。
+ * @param caterpillar [in] モーター・ブザー・LEDを制御するCaterpillarです。
+ * @param espNowManager [in] ペアリング状態を管理するESPNowManagerです。
+ * @param espNowOta [in] ESP-NOW経由のファームウェア更新を行うESPNowOtaです。
+ * @param peerMac [in] 通信相手(コントローラー)のMACアドレス (6バイト配列)。
+ */
+RobotController::RobotController(Caterpillar &caterpillar, ESPNowManager &espNowManager, ESPNowOta &espNowOta,
+                                 const uint8_t *peerMac)
+    : _caterpillar(caterpillar), _espNowManager(espNowManager), _espNowOta(espNowOta), _peerMac(peerMac),
+      _rxMux(portMUX_INITIALIZER_UNLOCKED), _receivedDataLength(0), _receivedData(), _sendData(), _linkStats(),
+      _previousMillis(0), _firstStepBuzzer(0), _lostCount(0) {
+}
+
+/**
+ * @brief ESP-NOWでデータを受信したときの処理です。受信コールバックから呼び出します。
+ * @param mac_addr [in] 送信元のMACアドレスです。
+ * @param incomingData [in] 受信した生データへのポインタです。
+ * @param len [in] 受信したデータの長さ（バイト数）です。
+ */
+void RobotController::onDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int len) {
+    if (_espNowOta.isOtaFrame(incomingData, len)) {
+        // OTAフレームはキューに積むだけにし、処理はupdate()内で行います
+        _espNowOta.enqueueFrame(mac_addr, incomingData, len);
+        return;
+    }
+    if (len == sizeof(ReceivedDataPacket)) {
+        // loop()がコピーの途中のデータを読まないよう、排他区間内でコピーします
+        portENTER_CRITICAL(&_rxMux);
+        memcpy(&_receivedData, incomingData, sizeof(ReceivedDataPacket)); // 受信データをコピーします
+        _receivedDataLength = len;
+        portEXIT_CRITICAL(&_rxMux);
+        _linkMonitor.onPacketReceived(); // 遅延計測用に受信時刻を記録します
+    } else {
+        Serial.printf("Received data size mismatch. Expected: %d, Got: %d\n", sizeof(ReceivedDataPacket), len);
+        portENTER_CRITICAL(&_rxMux);
+        _receivedDataLength = 0;
+        portEXIT_CRITICAL(&_rxMux);
+    }
+}
+
+/**
+ * @brief OTA転送を開始するとき(フラッシュ消去の直前)の処理です。ESPNowOtaの開始コールバックから呼び出します。
+ */
+void RobotController::onOtaBegin() {
+    _caterpillar.stop1();
+    _caterpillar.stop2();
+    _caterpillar.buzzerOff();
+    _firstStepBuzzer = 0;
+}
+
+/**
+ * @brief loop()から毎回呼び出す処理です。
+ */
+void RobotController::update() {
+    unsigned long currentMillis = millis(); // 現在時刻を取得します
+
+    // OTAフレームは転送速度を落とさないよう、処理間隔に関係なく毎回処理します
+    _espNowOta.process();
+
+    // 一定時間ごとに処理を実行します
+    if (currentMillis - _previousMillis >= LOOP_INTERVAL_MS) {
+        _previousMillis = currentMillis; // 実行時刻を更新します
+        _tick(currentMillis);
+    }
+}
+
+/**
+ * @brief 直近に集計した通信・制御の統計を返します。
+ * @return const LinkStats& 通信・制御の統計です。
+ */
+const LinkStats &RobotController::getLinkStats() const {
+    return _linkStats;
+}
+
+/**
+ * @brief LOOP_INTERVAL_MSごとの制御処理です。
+ * バッテリー電圧の取得、ESP-NOWでのデータ送信、受信データに基づくモーターとブザーの制御を行います。
+ * @param currentMillis [in] 現在時刻 (ミリ秒)。
+ */
+void RobotController::_tick(unsigned long currentMillis) {
+    // OTA更新中は走行を止め、制御パケットの処理を行いません
+    if (_espNowOta.isActive()) {
+        _caterpillar.stop1();
+        _caterpillar.stop2();
+        _caterpillar.buzzerOff();
+        // 青色LEDを高速点滅させて更新中であることを示します
+        _caterpillar.setBlueLed((currentMillis / 100) % 2 ? 255 : 0);
+        return;
+    }
+
+    int battery_value = _caterpillar.getVoltage();
+    // Serial.print("Battery: "); Serial.print(battery_value); Serial.println(" mV");
+    if (battery_value < 330) { // 330mV = 3.3V
+        // バッテリー電圧が3.3V未満の場合、白色LEDを点灯して警告します
+        _caterpillar.setWhiteLed(255); // 白色LEDを最大輝度で点灯
+    } else {
+        // ライトがONの場合は点灯、OFFの場合は消灯します
+        _caterpillar.setWhiteLed(_inputMapper.getState().lights ? 255 : 0);
+    }
+
+    /* ↓ここからメイン処理です↓ */
+    // ESP-NOWでペアリング済みか確認します
+    if (!_espNowManager.isPaired) {
+        // 安全のためモーターとブザーを停止します
+        _caterpillar.stop1();
+        _caterpillar.stop2();
+        _caterpillar.buzzerOff();
+        _caterpillar.setBlueLed(0); // ペアリングが切れたら青LEDを消灯
+        return;
+    }
+
+    _caterpillar.setBlueLed(255); // ペアリング中は点灯
+    // 集計間隔ごとに通信・制御の統計をシリアルに出力します
+    if (_linkMonitor.collect(_linkStats)) {
+        Serial.printf("Link: rx=%u act=%u latency p50=%uus p99=%uus max=%uus cpu=%uus failsafe=%u\n",
+                      _linkStats.rxPackets, _linkStats.actuations, _linkStats.latencyP50Us, _linkStats.latencyP99Us,
+                      _linkStats.latencyMaxUs, _linkStats.cpuAvgUs, _linkStats.failsafeTrips);
+    }
+    // 送信データを設定します (バッテリー電圧と直近の通信統計)
+    _sendData.val1 = battery_value;
+    _sendData.val2 = _linkStats.rxPackets;     // 直近1秒の受信パケット数
+    _sendData.val3 = _linkStats.latencyP50Us;  // 受信から反映までの遅延の中央値 (us)
+    _sendData.val4 = _linkStats.latencyP99Us;  // 受信から反映までの遅延の99パーセンタイル (us)
+    _sendData.val5 = _linkStats.failsafeTrips; // 起動からのフェイルセーフ発生回数
+    // データを送信します
+    esp_err_t result = esp_now_send(_peerMac, (uint8_t *)&_sendData, sizeof(_sendData));
+    // 送信結果を確認します (エラー時のみ表示)
+    if (result != ESP_OK) {
+        Serial.print("Send Error: ");
+        Serial.println(result);
+    }
+
+    // 処理時間は受信データの解釈・入力マッピング・ミキシングだけを計測します (シリアル出力やPWM出力は含めません)
+    unsigned long controlStartMicros = micros();
+    // 受信コールバックと同時に読み書きしないよう、排他区間内で受信データを手元にコピーします
+    // (以降はコピーだけを参照するため、処理中に次のパケットを受信しても値が混ざりません)
+    ReceivedDataPacket packet;
+    portENTER_CRITICAL(&_rxMux);
+    bool newPacket = _receivedDataLength > 0;  // 前回から新しいデータを受信したかどうかです
+    packet = _receivedData;
+    _receivedDataLength = 0;                   // 受信データ長をリセットします
+    portEXIT_CRITICAL(&_rxMux);
+
+    // 新しいデータを受信した場合のみ、スイッチの押下/解放をアクションに反映します
+    if (newPacket) {
+        _inputMapper.update(packet);
+    }
+    const ControlState &controlState = _inputMapper.getState();
+
+    // 選択中のミキサー・エクスポ・速度ギア・走行モードでスライダー値をモーター速度に変換します
+    _driveMixer.setMode(controlState.mixMode);
+    _driveMixer.setExpo(controlState.softExpo ? DriveMixer::SOFT_EXPO : DriveMixer::DEFAULT_EXPO);
+    _driveMixer.setSpeedScale(_inputMapper.getSpeedScale());
+    _driveMixer.setReversed(controlState.driveMode == DRIVE_MODE_REVERSED);
+    int rawSlideVal_1 = packet.slideVal1;
+    int rawSlideVal_2 = packet.slideVal2;
+    DriveOutput driveOutput = _driveMixer.mix(rawSlideVal_1, rawSlideVal_2);
+    uint32_t controlMicros = micros() - controlStartMicros;
+
+    // スライダー値とモーター速度の確認 (デバッグ用、現在は無効)
+    // 毎周期のシリアル出力は受信から反映までの遅延を大きくするため、通常はLink統計を参照してください
+    # if 0
+    Serial.print("Slide1: "); Serial.print(rawSlideVal_1); Serial.print(" -> Speed1: "); Serial.print(driveOutput.motor1);
+    Serial.print(" | Slide2: "); Serial.print(rawSlideVal_2); Serial.print(" -> Speed2: "); Serial.println(driveOutput.motor2);
+    # endif
+
+    /* モーター1の制御 (ミキサー出力に基づく) */
+    // 0以上なら前進方向、負なら後進方向に制御します
+    if (driveOutput.motor1 >= 0) {
+        _caterpillar.forward1(driveOutput.motor1);
+    } else {
+        _caterpillar.backward1(-driveOutput.motor1);
+    }
+
+    /* モーター2の制御 (ミキサー出力に基づく) */
+    if (driveOutput.motor2 >= 0) {
+        _caterpillar.forward2(driveOutput.motor2);
+    } else {
+        _caterpillar.backward2(-driveOutput.motor2);
+    }
+
+    // 新しいデータをモーターへ反映した場合、受信からの遅延と処理時間を記録します
+    if (newPacket) {
+        _linkMonitor.onActuated(controlMicros);
+    }
+
+    /* ブザーの制御 (InputMapperのホーン状態に基づく) */
+    // ホーンがONになったらブザーを鳴らし、OFFになったら止めます
+    if (controlState.horn) {
+        if (_firstStepBuzzer == 0) {
+            _caterpillar.buzzerOn();
+            _firstStepBuzzer = 1;
+        }
+    } else {
+        _caterpillar.buzzerOff();
+        _firstStepBuzzer = 0;
+    }
+
+    // データを受信したか確認します (ペアリング中のみ実行)
+    if (newPacket) {
+        _lostCount = 0; // 通信ロス回数カウントをリセットします
+    } else {
+        _lostCount++;
+        if (_lostCount > COMMUNICATION_LOST_THRESHOLD) {
+            if (_lostCount == COMMUNICATION_LOST_THRESHOLD + 1) {
+                _linkMonitor.onFailsafeTrip(); // ロスと判断した時点で1回だけ記録します
+            }
+            // ペアリングされていない場合の処理です (ブリージングエフェクト)
+            // 2000ms (2秒)周期で明るさを計算します
+            float rad = (millis() % 2000) / 2000.0 * 2.0 * PI;
+            // sinカーブを使い、0-255の範囲で滑らかな明るさの変化を生成します
+            int brightness = (int)((sin(rad - PI / 2.0) + 1.0) / 2.0 * 255);
+            _caterpillar.setBlueLed(brightness);
+            _caterpillar.stop1();
+            _caterpillar.stop2();
+            _caterpillar.buzzerOff();
+            // ブザーを止めます (押されているスイッチの状態は保持し、再接続時に押下とみなさないようにします)
+            _inputMapper.reset();
+            _firstStepBuzzer = 0;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef ROBOTCONTROLLER_H
+#define ROBOTCONTROLLER_H
+
+#include <Arduino.h>
+#include <esp_now.h>
+#include <freertos/FreeRTOS.h>
+#include "Caterpillar.h"
+#include "ESPNowManager.h"
+#include "ESPNowOta.h"
+#include "InputMapper.h"
+#include "DriveMixer.h"
+#include "LinkMonitor.h"
+#include "DataStructures.h"
+
+/**
+ * @brief ESP-NOWで受信した操縦データをモーター・ブザー・LEDの動作に反映するクラスです。
+ * 受信コールバックとloop()の処理本体をまとめたもので、main.cppから呼び出します。
+ * ハードウェアに依存する処理はCaterpillar・ESPNowManager・ESPNowOtaに任せるため、
+ * それらを差し替えればホスト上でも同じ制御処理を動かせます。
+ */
+class RobotController {
+public:
+    // --- 制御設定定数 ---
+    static const int LOOP_INTERVAL_MS = 20;             // 制御処理を実行する間隔 (ミリ秒)
+    static const int COMMUNICATION_LOST_THRESHOLD = 10; // 10回 * 20ms = 200ms程度受信がなければロスと判断
+
+    /**
+     * @brief RobotControllerクラスのコンストラクタです。
+     * @param caterpillar [in] モーター・ブザー・LEDを制御するCaterpillarです。
+     * @param espNowManager [in] ペアリング状態を管理するESPNowManagerです。
+     * @param espNowOta [in] ESP-NOW経由のファームウェア更新を行うESPNowOtaです。
+     * @param peerMac [in] 通信相手(コントローラー)のMACアドレス (6バイト配列)。
+     */
+    RobotController(Caterpillar &caterpillar, ESPNowManager &espNowManager, ESPNowOta &espNowOta,
+                    const uint8_t *peerMac);
+
+    /**
+     * @brief ESP-NOWでデータを受信したときの処理です。受信コールバックから呼び出します。
+     * @param mac_addr [in] 送信元のMACアドレスです。
+     * @param incomingData [in] 受信した生データへのポインタです。
+     * @param len [in] 受信したデータの長さ（バイト数）です。
+     */
+    void onDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int len);
+
+    /**
+     * @brief OTA転送を開始するとき(フラッシュ消去の直前)の処理です。ESPNowOtaの開始コールバックから呼び出します。
+     * 消去の間は制御処理が動かないため、モーターとブザーを止めます。
+     */
+    void onOtaBegin();
+
+    /**
+     * @brief loop()から毎回呼び出す処理です。
+     * OTAフレームを処理し、LOOP_INTERVAL_MSごとにバッテリー監視・テレメトリ送信・
+     * 受信データに基づくモーターとブザーの制御・通信ロス判定を行います。
+     */
+    void update();
+
+    /**
+     * @brief 直近に集計した通信・制御の統計を返します。
+     * @return const LinkStats& 通信・制御の統計です。
+     */
+    const LinkStats &getLinkStats() const;
+
+private:
+    Caterpillar &_caterpillar;
+    ESPNowManager &_espNowManager;
+    ESPNowOta &_espNowOta;
+    const uint8_t *_peerMac;                // 通信相手のMACアドレス (呼び出し側が保持します)
+
+    InputMapper _inputMapper;               // スイッチ入力をアクションに割り当てます
+    DriveMixer _driveMixer;                 // スライダー入力を左右のモーター速度に変換します
+    LinkMonitor _linkMonitor;               // 通信遅延・フェイルセーフ・処理時間を計測します
+
+    // --- 受信コールバックと共有する値 (_rxMuxで保護します) ---
+    portMUX_TYPE _rxMux;                    // 受信コールバック(Wi-Fiタスク)とloop()の排他制御用
+    int _receivedDataLength;                // 受信したデータの長さ (新しいデータがなければ0)
+    ReceivedDataPacket _receivedData;       // 受信データ
+
+    SaneDataPacket _sendData;               // 送信データ
+    LinkStats _linkStats;                   // 直近に集計した通信・制御の統計 (送信データに載せます)
+    unsigned long _previousMillis;          // 制御処理の間隔を管理するためのタイマー変数です
+    int _firstStepBuzzer;                   // ブザー制御の初回ステップフラグです
+    int _lostCount;                         // ESP-NOWの通信ロス回数です
+
+    // --- プライベートヘルパー関数 ---
+    void _tick(unsigned long currentMillis);
+};
+
+#endif // ROBOTCONTROLLER_H
@@ -0,0 +1,82 @@
+// ホスト(native)テスト用のArduino関数の代替実装です。
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+FakeSerial Serial;
+FakeEsp ESP;
+FakeWiFi WiFi;
+
+// --- 仮想時計 ---
+
+static uint64_t fakeMicros = 0;
+
+void FakeClock::reset() {
+    fakeMicros = 0;
+}
+
+void FakeClock::advanceMicros(uint64_t us) {
+    fakeMicros += us;
+}
+
+uint64_t FakeClock::nowMicros() {
+    return fakeMicros;
+}
+
+unsigned long millis() {
+    return (unsigned long)(fakeMicros / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)fakeMicros;
+}
+
+void delay(unsigned long ms) {
+    fakeMicros += (uint64_t)ms * 1000;
+}
+
+void FakeEsp::restart() {
+    restartCount++;
+}
+
+// --- LEDC・ADC ---
+
+static int ledcDuty[FakeLedc::CHANNEL_COUNT];
+static int ledcTone[FakeLedc::CHANNEL_COUNT];
+static int adcValue = 4095;
+
+void FakeLedc::reset() {
+    memset(ledcDuty, 0, sizeof(ledcDuty));
+    memset(ledcTone, 0, sizeof(ledcTone));
+}
+
+int FakeLedc::duty(int channel) {
+    return ledcDuty[channel];
+}
+
+int FakeLedc::tone(int channel) {
+    return ledcTone[channel];
+}
+
+void ledcSetup(int, int, int) {}
+
+void ledcAttachPin(int, int) {}
+
+void ledcWrite(int channel, int duty) {
+    ledcDuty[channel] = duty;
+    ledcTone[channel] = 0;
+}
+
+void ledcWriteTone(int channel, int freq) {
+    ledcTone[channel] = freq;
+}
+
+void pinMode(int, int) {}
+
+int analogRead(int) {
+    return adcValue;
+}
+
+void FakeAdc::setValue(int value) {
+    adcValue = value;
+}
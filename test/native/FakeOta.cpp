@@ -0,0 +1,203 @@
+// ホスト(native)テスト用の、OTA受信(ESPNowOta)が使うESP-IDF・FreeRTOS・ROM関数の代替実装です。
+
+#include "FakeOta.h"
+#include <Arduino.h>
+#include <esp32/rom/crc.h>
+#include <esp32/rom/miniz.h>
+#include <freertos/queue.h>
+#include <deque>
+
+static esp_partition_t otaPartition = {0x150000, 0x140000};
+static std::vector<uint8_t> otaImage;
+static std::function<void()> otaBeginHook;
+static uint64_t otaEraseMicros = 0;
+static esp_err_t otaEndResult = ESP_OK;
+static int otaBeginCount = 0;
+static bool otaOpen = false;
+static bool otaEnded = false;
+static bool otaAborted = false;
+static bool otaBootSet = false;
+static size_t queueAllocatedBytes = 0;
+
+void FakeOta::reset(uint32_t partitionSize) {
+    otaPartition.size = partitionSize;
+    otaImage.clear();
+    otaBeginHook = nullptr;
+    otaEraseMicros = 0;
+    otaEndResult = ESP_OK;
+    otaBeginCount = 0;
+    otaOpen = false;
+    otaEnded = false;
+    otaAborted = false;
+    otaBootSet = false;
+    queueAllocatedBytes = 0;
+}
+
+void FakeOta::setEraseMicros(uint64_t us) {
+    otaEraseMicros = us;
+}
+
+void FakeOta::setBeginHook(std::function<void()> hook) {
+    otaBeginHook = hook;
+}
+
+void FakeOta::setEndResult(esp_err_t result) {
+    otaEndResult = result;
+}
+
+const std::vector<uint8_t> &FakeOta::image() {
+    return otaImage;
+}
+
+int FakeOta::beginCount() {
+    return otaBeginCount;
+}
+
+bool FakeOta::ended() {
+    return otaEnded;
+}
+
+bool FakeOta::aborted() {
+    return otaAborted;
+}
+
+bool FakeOta::bootPartitionSet() {
+    return otaBootSet;
+}
+
+size_t FakeOta::queueBytes() {
+    return queueAllocatedBytes;
+}
+
+// --- esp_ota_*の実装 ---
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *) {
+    return &otaPartition;
+}
+
+esp_err_t esp_ota_begin(const esp_partition_t *partition, size_t image_size, esp_ota_handle_t *out_handle) {
+    if (image_size > partition->size) {
+        return ESP_FAIL;
+    }
+    otaBeginCount++;
+    if (otaBeginHook) {
+        otaBeginHook();
+    }
+    // 実機では消去の間ブロックするため、その分だけ仮想時計を進めます
+    FakeClock::advanceMicros(otaEraseMicros);
+    otaImage.clear();
+    otaOpen = true;
+    otaEnded = false;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size) {
+    if (handle != 1 || !otaOpen) {
+        return ESP_FAIL;
+    }
+    const uint8_t *bytes = (const uint8_t *)data;
+    otaImage.insert(otaImage.end(), bytes, bytes + size);
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_end(esp_ota_handle_t handle) {
+    if (handle != 1 || !otaOpen) {
+        return ESP_FAIL;
+    }
+    otaOpen = false;
+    otaEnded = (otaEndResult == ESP_OK);
+    return otaEndResult;
+}
+
+esp_err_t esp_ota_abort(esp_ota_handle_t) {
+    otaOpen = false;
+    otaAborted = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *) {
+    otaBootSet = true;
+    return ESP_OK;
+}
+
+// --- FreeRTOSキュー ---
+
+struct FakeQueue {
+    uint32_t length;
+    uint32_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(uint32_t length, uint32_t itemSize) {
+    queueAllocatedBytes += (size_t)length * itemSize;
+    return new FakeQueue{length, itemSize, {}};
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t) {
+    if (queue->items.size() >= queue->length) {
+        return pdFALSE;
+    }
+    const uint8_t *bytes = (const uint8_t *)item;
+    queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->itemSize));
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t) {
+    if (queue->items.empty()) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+
+// --- ROM関数 ---
+
+uint32_t crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len) {
+    return (uint32_t)crc32(crc, buf, len);
+}
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const uint8_t *pIn_buf_next, size_t *pIn_buf_size,
+                              uint8_t *, uint8_t *pOut_buf_next, size_t *pOut_buf_size,
+                              const mz_uint32 decomp_flags) {
+    if (r->m_state == 0) {
+        // tinfl_init()直後はm_streamの内容を信用せず、新しく初期化します
+        memset(&r->m_stream, 0, sizeof(r->m_stream));
+        int windowBits = (decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER) ? 15 : -15;
+        if (inflateInit2(&r->m_stream, windowBits) != Z_OK) {
+            return TINFL_STATUS_FAILED;
+        }
+        r->m_state = 1;
+    }
+    if (r->m_state != 1) {
+        *pIn_buf_size = 0;
+        *pOut_buf_size = 0;
+        return (r->m_state == 2) ? TINFL_STATUS_DONE : TINFL_STATUS_FAILED;
+    }
+
+    z_stream &stream = r->m_stream;
+    stream.next_in = (Bytef *)pIn_buf_next;
+    stream.avail_in = (uInt)*pIn_buf_size;
+    stream.next_out = pOut_buf_next;
+    stream.avail_out = (uInt)*pOut_buf_size;
+    int ret = inflate(&stream, Z_NO_FLUSH);
+    *pIn_buf_size -= stream.avail_in;
+    *pOut_buf_size -= stream.avail_out;
+
+    if (ret == Z_STREAM_END) {
+        inflateEnd(&stream);
+        r->m_state = 2;
+        return TINFL_STATUS_DONE;
+    }
+    if (ret == Z_OK || ret == Z_BUF_ERROR) {
+        if (stream.avail_out == 0) {
+            return TINFL_STATUS_HAS_MORE_OUTPUT;
+        }
+        return (decomp_flags & TINFL_FLAG_HAS_MORE_INPUT) ? TINFL_STATUS_NEEDS_MORE_INPUT
+                                                          : TINFL_STATUS_FAILED_CANNOT_MAKE_PROGRESS;
+    }
+    inflateEnd(&stream);
+    r->m_state = 3;
+    return TINFL_STATUS_FAILED;
+}
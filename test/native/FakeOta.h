@@ -0,0 +1,42 @@
+#ifndef FAKEOTA_H
+#define FAKEOTA_H
+
+// ホスト(native)テスト用のOTAパーティションの代替です。
+// esp_ota_*で書き込まれたイメージをメモリに保持し、呼び出しの記録をテストから参照できるようにします。
+// OTA受信だけが使うFreeRTOSキュー・ROMのCRC32/tinfl(zlibで実装)の代替もFakeOta.cppにあります。
+
+#include <esp_ota_ops.h>
+#include <functional>
+#include <vector>
+
+namespace FakeOta {
+    /**
+     * @brief 状態を初期化します。
+     * @param partitionSize [in] 書き込み先パーティションの大きさです。
+     */
+    void reset(uint32_t partitionSize = 0x140000);
+
+    /**
+     * @brief esp_ota_begin()での消去にかかる時間を設定します (仮想時計をその分進めます)。
+     */
+    void setEraseMicros(uint64_t us);
+
+    /**
+     * @brief esp_ota_begin()の消去開始時に呼ばれる関数を設定します。
+     */
+    void setBeginHook(std::function<void()> hook);
+
+    /**
+     * @brief esp_ota_end()の戻り値を設定します (イメージ検証の失敗を模擬します)。
+     */
+    void setEndResult(esp_err_t result);
+
+    const std::vector<uint8_t> &image(); // 書き込まれたイメージ
+    int beginCount();                    // esp_ota_begin()の呼び出し回数
+    bool ended();                        // esp_ota_end()が成功したか
+    bool aborted();                      // esp_ota_abort()が呼ばれたか
+    bool bootPartitionSet();             // esp_ota_set_boot_partition()が呼ばれたか
+    size_t queueBytes();                 // reset()以降にxQueueCreate()で確保されたバイト数
+}
+
+#endif // FAKEOTA_H
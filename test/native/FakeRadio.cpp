@@ -0,0 +1,200 @@
+#include "FakeRadio.h"
+
+static const uint8_t BROADCAST_MAC[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+FakeRadio &FakeRadio::instance() {
+    static FakeRadio radio;
+    return radio;
+}
+
+FakeRadio::FakeRadio() {
+    reset(1);
+}
+
+void FakeRadio::reset(uint32_t seed) {
+    initialized = false;
+    recvCallback = nullptr;
+    sendCallback = nullptr;
+    peers.clear();
+    deviceMac.assign(6, 0);
+    _config = RadioLinkConfig();
+    _stats = RadioStats();
+    _random.seed(seed);
+    _frames = decltype(_frames)();
+    _nodes.clear();
+    _lastDeliverAt.clear();
+    _busyUntil = 0;
+    _order = 0;
+}
+
+void FakeRadio::setDeviceMac(const uint8_t *mac) {
+    deviceMac.assign(mac, mac + 6);
+}
+
+void FakeRadio::configure(const RadioLinkConfig &config) {
+    _config = config;
+}
+
+void FakeRadio::attachNode(const uint8_t *mac, Receiver receiver) {
+    _nodes.push_back(std::make_pair(std::vector<uint8_t>(mac, mac + 6), receiver));
+}
+
+bool FakeRadio::transmit(const uint8_t *srcMac, const uint8_t *dstMac, const uint8_t *data, int len) {
+    _stats.transmitted++;
+
+    // 媒体が使用中なら空くまで待ってから送信します (多数の送信元による混雑を表します)
+    uint64_t now = FakeClock::nowMicros();
+    uint64_t start = std::max(now, _busyUntil);
+    _busyUntil = start + (uint64_t)_config.airtimeUsPerByte * len;
+
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    if (chance(_random) < _config.lossRate) {
+        _stats.dropped++;
+        return false;
+    }
+
+    int copies = (chance(_random) < _config.duplicateRate) ? 2 : 1;
+    for (int i = 0; i < copies; i++) {
+        Frame frame;
+        frame.deliverAt = _busyUntil + _sampleLatency();
+        frame.order = _order++;
+        frame.src.assign(srcMac, srcMac + 6);
+        frame.dst.assign(dstMac, dstMac + 6);
+        frame.data.assign(data, data + len);
+
+        if (!_config.allowReorder) {
+            // 宛先ごとに前のフレームより先に届かないようにします
+            bool found = false;
+            for (auto &last : _lastDeliverAt) {
+                if (last.first == frame.dst) {
+                    frame.deliverAt = std::max(frame.deliverAt, last.second);
+                    last.second = frame.deliverAt;
+                    found = true;
+                }
+            }
+            if (!found) {
+                _lastDeliverAt.push_back(std::make_pair(frame.dst, frame.deliverAt));
+            }
+        }
+        if (i > 0) {
+            _stats.duplicated++;
+        }
+        _frames.push(frame);
+    }
+    return true;
+}
+
+void FakeRadio::runUntil(uint64_t timeUs) {
+    while (!_frames.empty() && _frames.top().deliverAt <= timeUs) {
+        Frame frame = _frames.top();
+        _frames.pop();
+        if (frame.deliverAt > FakeClock::nowMicros()) {
+            FakeClock::advanceMicros(frame.deliverAt - FakeClock::nowMicros());
+        }
+        _deliver(frame);
+    }
+    if (timeUs > FakeClock::nowMicros()) {
+        FakeClock::advanceMicros(timeUs - FakeClock::nowMicros());
+    }
+}
+
+size_t FakeRadio::pending() const {
+    return _frames.size();
+}
+
+const RadioStats &FakeRadio::getStats() const {
+    return _stats;
+}
+
+uint64_t FakeRadio::_sampleLatency() {
+    double latency = _config.latencyUs;
+    switch (_config.distribution) {
+    case LATENCY_UNIFORM: {
+        std::uniform_real_distribution<double> dist(-(double)_config.jitterUs, (double)_config.jitterUs);
+        latency += dist(_random);
+        break;
+    }
+    case LATENCY_NORMAL: {
+        std::normal_distribution<double> dist(0.0, (double)_config.jitterUs);
+        latency += dist(_random);
+        break;
+    }
+    case LATENCY_EXPONENTIAL:
+        if (_config.jitterUs > 0) {
+            std::exponential_distribution<double> dist(1.0 / _config.jitterUs);
+            latency += dist(_random);
+        }
+        break;
+    case LATENCY_FIXED:
+    default:
+        break;
+    }
+    return latency > 0 ? (uint64_t)latency : 0;
+}
+
+void FakeRadio::_deliver(const Frame &frame) {
+    bool broadcast = memcmp(frame.dst.data(), BROADCAST_MAC, 6) == 0;
+    if ((broadcast || frame.dst == deviceMac) && frame.src != deviceMac) {
+        if (initialized && recvCallback != nullptr) {
+            _stats.delivered++;
+            recvCallback(frame.src.data(), frame.data.data(), (int)frame.data.size());
+        }
+    }
+    for (auto &node : _nodes) {
+        if ((broadcast || node.first == frame.dst) && node.first != frame.src) {
+            _stats.delivered++;
+            node.second(frame.src.data(), frame.data.data(), (int)frame.data.size());
+        }
+    }
+}
+
+// --- esp_now_*の実装 (テスト対象の機体から呼ばれます) ---
+
+esp_err_t esp_now_init() {
+    FakeRadio::instance().initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_deinit() {
+    FakeRadio::instance().initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb) {
+    FakeRadio::instance().recvCallback = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) {
+    FakeRadio::instance().sendCallback = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t *peer) {
+    FakeRadio &radio = FakeRadio::instance();
+    if (!radio.initialized) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    radio.peers.insert(std::vector<uint8_t>(peer->peer_addr, peer->peer_addr + 6));
+    return ESP_OK;
+}
+
+bool esp_now_is_peer_exist(const uint8_t *peer_addr) {
+    return FakeRadio::instance().peers.count(std::vector<uint8_t>(peer_addr, peer_addr + 6)) > 0;
+}
+
+esp_err_t esp_now_send(const uint8_t *peer_addr, const uint8_t *data, size_t len) {
+    FakeRadio &radio = FakeRadio::instance();
+    if (!radio.initialized) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    if (!esp_now_is_peer_exist(peer_addr)) {
+        return ESP_ERR_ESPNOW_NOT_FOUND;
+    }
+    bool ok = radio.transmit(radio.deviceMac.data(), peer_addr, data, (int)len);
+    if (radio.sendCallback != nullptr) {
+        // 実機と同じく、相手からのMAC層ACKの有無を送信完了コールバックで通知します
+        radio.sendCallback(peer_addr, ok ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+    }
+    return ESP_OK;
+}
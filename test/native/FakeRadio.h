@@ -0,0 +1,130 @@
+#ifndef FAKERADIO_H
+#define FAKERADIO_H
+
+// ホスト(native)テスト用の疑似ESP-NOW無線媒体です。
+// esp_now_send()/esp_now_register_recv_cb()の代替として、ファームウェア(テスト対象の機体)と
+// テストハーネス側のノード(コントローラー、OTA送信側、干渉ノードなど)の間でフレームを運びます。
+// パケットロス・遅延分布・ジッター・重複・順序入れ替え・送信の衝突待ち(エアタイム)を模擬できます。
+
+#include <Arduino.h>
+#include <esp_now.h>
+#include <functional>
+#include <queue>
+#include <random>
+#include <set>
+#include <vector>
+
+// 遅延の分布です
+enum LatencyDistribution {
+    LATENCY_FIXED,        // 常にlatencyUs
+    LATENCY_UNIFORM,      // latencyUs ± jitterUs の一様分布
+    LATENCY_NORMAL,       // 平均latencyUs、標準偏差jitterUsの正規分布 (負にはなりません)
+    LATENCY_EXPONENTIAL,  // latencyUs + 平均jitterUsの指数分布 (裾の長い遅延)
+};
+
+// 無線リンクの設定です
+struct RadioLinkConfig {
+    double lossRate;                  // フレームが失われる確率 (0-1)
+    double duplicateRate;             // フレームが重複して届く確率 (0-1)
+    uint32_t latencyUs;               // 基本の伝搬・処理遅延
+    uint32_t jitterUs;                // 遅延のばらつき (分布ごとの意味はLatencyDistributionを参照)
+    LatencyDistribution distribution; // 遅延の分布
+    bool allowReorder;                // falseの場合、宛先ごとに送信順で届けます
+    uint32_t airtimeUsPerByte;        // 1バイトあたりの占有時間 (0で衝突待ちなし)。1Mbpsで8us
+
+    RadioLinkConfig()
+        : lossRate(0), duplicateRate(0), latencyUs(1000), jitterUs(0), distribution(LATENCY_FIXED),
+          allowReorder(true), airtimeUsPerByte(8) {}
+};
+
+// 媒体の統計です
+struct RadioStats {
+    uint32_t transmitted;  // 送信されたフレーム数
+    uint32_t dropped;      // 失われたフレーム数
+    uint32_t duplicated;   // 重複して届けたフレーム数
+    uint32_t delivered;    // 届けたフレーム数 (重複を含みます)
+};
+
+/**
+ * @brief 疑似ESP-NOW無線媒体です。esp_now_*関数はこのシングルトンを経由します。
+ */
+class FakeRadio {
+public:
+    typedef std::function<void(const uint8_t *srcMac, const uint8_t *data, int len)> Receiver;
+
+    static FakeRadio &instance();
+
+    /**
+     * @brief 媒体の状態・設定・統計・コールバックをすべて初期化します。
+     * @param seed [in] 乱数の種です (同じ種なら同じ結果になります)。
+     */
+    void reset(uint32_t seed);
+
+    /**
+     * @brief テスト対象の機体(esp_now_*を呼ぶ側)のMACアドレスを設定します。
+     */
+    void setDeviceMac(const uint8_t *mac);
+
+    /**
+     * @brief リンク設定を変更します。以降に送信されたフレームに適用されます。
+     */
+    void configure(const RadioLinkConfig &config);
+
+    /**
+     * @brief ハーネス側のノードを登録します。そのMAC宛のフレームはreceiverに届けられます。
+     */
+    void attachNode(const uint8_t *mac, Receiver receiver);
+
+    /**
+     * @brief 任意のノードからフレームを送信します。ロス・遅延・重複を適用して配送を予約します。
+     * @return bool フレームが失われなかった場合はtrueを返します。
+     */
+    bool transmit(const uint8_t *srcMac, const uint8_t *dstMac, const uint8_t *data, int len);
+
+    /**
+     * @brief 指定時刻までに届くフレームを時刻順に配送し、仮想時計をその時刻まで進めます。
+     * @param timeUs [in] 進める先の時刻 (マイクロ秒)。
+     */
+    void runUntil(uint64_t timeUs);
+
+    /**
+     * @brief 配送待ちのフレーム数を返します。
+     */
+    size_t pending() const;
+
+    const RadioStats &getStats() const;
+
+    // --- esp_now_*の実装から使う値 ---
+    bool initialized;
+    esp_now_recv_cb_t recvCallback;
+    esp_now_send_cb_t sendCallback;
+    std::set<std::vector<uint8_t>> peers;
+    std::vector<uint8_t> deviceMac;
+
+private:
+    struct Frame {
+        uint64_t deliverAt;
+        uint64_t order;
+        std::vector<uint8_t> src;
+        std::vector<uint8_t> dst;
+        std::vector<uint8_t> data;
+        bool operator>(const Frame &other) const {
+            return deliverAt != other.deliverAt ? deliverAt > other.deliverAt : order > other.order;
+        }
+    };
+
+    FakeRadio();
+    uint64_t _sampleLatency();
+    void _deliver(const Frame &frame);
+
+    RadioLinkConfig _config;
+    RadioStats _stats;
+    std::mt19937 _random;
+    std::priority_queue<Frame, std::vector<Frame>, std::greater<Frame>> _frames;
+    std::vector<std::pair<std::vector<uint8_t>, Receiver>> _nodes;
+    std::vector<std::pair<std::vector<uint8_t>, uint64_t>> _lastDeliverAt; // 宛先ごとの最後の配送時刻
+    uint64_t _busyUntil;   // 媒体が空く時刻
+    uint64_t _order;       // 同時刻のフレームの配送順
+};
+
+#endif // FAKERADIO_H
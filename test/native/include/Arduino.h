@@ -0,0 +1,71 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// ホスト(native)テスト用のArduino APIの代替です。
+// 時刻は仮想時計(FakeClock)で進め、LEDC出力は記録してテストから参照できるようにします。
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::abs;
+using std::max;
+using std::min;
+
+#define PI 3.1415926535897932384626433832795
+#define INPUT 0x01
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// --- 仮想時計 ---
+namespace FakeClock {
+    void reset();                  // 時刻を0に戻します
+    void advanceMicros(uint64_t us); // 時刻を進めます
+    uint64_t nowMicros();          // 現在時刻 (マイクロ秒)
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);      // 仮想時計を進めるだけで、実際には待ちません
+
+// --- LEDC (PWM) ---
+namespace FakeLedc {
+    const int CHANNEL_COUNT = 16;
+    void reset();                  // 全チャンネルのデューティを0に戻します
+    int duty(int channel);         // 最後に書き込まれたデューティ
+    int tone(int channel);         // 最後に書き込まれたトーン周波数 (ledcWrite()で0に戻ります)
+}
+
+void ledcSetup(int channel, int freq, int resolution);
+void ledcAttachPin(int pin, int channel);
+void ledcWrite(int channel, int duty);
+void ledcWriteTone(int channel, int freq);
+void pinMode(int pin, int mode);
+int analogRead(int pin);
+namespace FakeAdc {
+    void setValue(int value);      // analogRead()の戻り値を設定します
+}
+
+// --- Serial ---
+class FakeSerial {
+public:
+    void begin(unsigned long) {}
+    size_t print(const char *) { return 0; }
+    size_t print(int) { return 0; }
+    size_t println(const char * = "") { return 0; }
+    size_t println(int) { return 0; }
+    size_t printf(const char *, ...) { return 0; }
+};
+extern FakeSerial Serial;
+
+// --- ESP ---
+class FakeEsp {
+public:
+    void restart();
+    int restartCount = 0;          // restart()が呼ばれた回数
+};
+extern FakeEsp ESP;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,18 @@
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include <Arduino.h>
+
+#define WIFI_STA 1
+
+// ホスト(native)テスト用のWiFiクラスの代替です。
+class FakeWiFi {
+public:
+    void mode(int) {}
+    void disconnect() {}
+    const char *macAddress() { return "00:00:00:00:00:00"; }
+    int channel() { return 1; }
+};
+extern FakeWiFi WiFi;
+
+#endif // NATIVE_WIFI_H
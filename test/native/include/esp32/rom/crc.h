@@ -0,0 +1,10 @@
+#ifndef NATIVE_ROM_CRC_H
+#define NATIVE_ROM_CRC_H
+
+// ホスト(native)テスト用のROM CRC関数の代替です (zlibのcrc32と同じ値を返します)。
+
+#include <stdint.h>
+
+uint32_t crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len);
+
+#endif // NATIVE_ROM_CRC_H
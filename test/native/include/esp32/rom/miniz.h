@@ -0,0 +1,44 @@
+#ifndef NATIVE_ROM_MINIZ_H
+#define NATIVE_ROM_MINIZ_H
+
+// ホスト(native)テスト用のROM miniz(tinfl)の代替です。
+// ESP32のROMと同じtinfl_decompress()の呼び出し規約を、ホストのzlibで実装しています。
+
+#include <stdint.h>
+#include <stddef.h>
+#include <zlib.h>
+
+typedef uint32_t mz_uint32;
+
+enum {
+    TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+    TINFL_FLAG_HAS_MORE_INPUT = 2,
+    TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF = 4,
+};
+
+#define TINFL_LZ_DICT_SIZE 32768
+
+typedef enum {
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2,
+} tinfl_status;
+
+#define TINFL_STATUS_FAILED_CANNOT_MAKE_PROGRESS TINFL_STATUS_BAD_PARAM
+
+typedef struct {
+    mz_uint32 m_state;   // 0: 未初期化 (tinfl_init()で0に戻ります), 1: 展開中, 2: 完了, 3: エラー
+    z_stream m_stream;   // m_state == 1 の間だけ有効です
+} tinfl_decompressor;
+
+// ROMのtinfl_init()と同じく、構造体の他の内容は未初期化でも構いません
+#define tinfl_init(r) do { (r)->m_state = 0; } while (0)
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const uint8_t *pIn_buf_next, size_t *pIn_buf_size,
+                              uint8_t *pOut_buf_start, uint8_t *pOut_buf_next, size_t *pOut_buf_size,
+                              const mz_uint32 decomp_flags);
+
+#endif // NATIVE_ROM_MINIZ_H
@@ -0,0 +1,22 @@
+#ifndef NATIVE_ESP_OTA_OPS_H
+#define NATIVE_ESP_OTA_OPS_H
+
+// ホスト(native)テスト用のOTA APIの代替です。実体はFakeOta.cppにあります。
+
+#include <esp_now.h>
+
+typedef uint32_t esp_ota_handle_t;
+
+typedef struct {
+    uint32_t address;
+    uint32_t size;
+} esp_partition_t;
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from);
+esp_err_t esp_ota_begin(const esp_partition_t *partition, size_t image_size, esp_ota_handle_t *out_handle);
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size);
+esp_err_t esp_ota_end(esp_ota_handle_t handle);
+esp_err_t esp_ota_abort(esp_ota_handle_t handle);
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition);
+
+#endif // NATIVE_ESP_OTA_OPS_H
@@ -0,0 +1,21 @@
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+// ホスト(native)テスト用のFreeRTOS APIの代替です。
+// テストは単一スレッドで動くため、クリティカルセクションは何もしません。
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+#define pdTRUE 1
+#define pdFALSE 0
+
+typedef struct {
+    int count;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((mux)->count++)
+#define portEXIT_CRITICAL(mux) ((mux)->count--)
+
+#endif // NATIVE_FREERTOS_H
@@ -0,0 +1,14 @@
+#ifndef NATIVE_FREERTOS_QUEUE_H
+#define NATIVE_FREERTOS_QUEUE_H
+
+// ホスト(native)テスト用のFreeRTOSキューの代替です。実体はFakeOta.cppにあります。
+
+#include <freertos/FreeRTOS.h>
+
+typedef struct FakeQueue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(uint32_t length, uint32_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticksToWait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticksToWait);
+
+#endif // NATIVE_FREERTOS_QUEUE_H
@@ -0,0 +1,133 @@
+// DriveMixerの全入力(スライダー1 x スライダー2 = 256 x 256)を、すべてのミキサー・エクスポ・
+// 速度ギア・走行モードの組み合わせで掃引し、出力範囲・対称性・中央値・連続性を確認します。
+
+#include <unity.h>
+#include <stdio.h>
+#include "DriveMixer.h"
+
+// 隣り合うスライダー値(1カウント差)で許容するPWM出力の変化量です。
+// デッドバンドの境目や超信地旋回への切り替えで出力が跳ばないことを確認します
+static const int MAX_STEP_PER_COUNT = 16;
+
+static const int EXPOS[] = {DriveMixer::DEFAULT_EXPO, DriveMixer::SOFT_EXPO, DriveMixer::FIXED_ONE};
+static const int SPEED_SCALES[] = {DriveMixer::FIXED_ONE / 3, DriveMixer::FIXED_ONE * 2 / 3, DriveMixer::FIXED_ONE};
+
+// すべての設定の組み合わせについてcheckを呼び出します
+template <typename Check>
+static void forEachConfig(Check check) {
+    for (int mode = 0; mode < MIX_MODE_COUNT; mode++) {
+        for (int expo : EXPOS) {
+            for (int scale : SPEED_SCALES) {
+                for (int reversed = 0; reversed < 2; reversed++) {
+                    DriveMixer mixer;
+                    mixer.setMode((MixMode)mode);
+                    mixer.setExpo(expo);
+                    mixer.setSpeedScale(scale);
+                    mixer.setReversed(reversed != 0);
+                    check(mixer);
+                }
+            }
+        }
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_outputs_stay_within_pwm_range() {
+    forEachConfig([](const DriveMixer &mixer) {
+        for (int a = 0; a < 256; a++) {
+            for (int b = 0; b < 256; b++) {
+                DriveOutput out = mixer.mix(a, b);
+                TEST_ASSERT_INT_WITHIN(255, 0, out.motor1);
+                TEST_ASSERT_INT_WITHIN(255, 0, out.motor2);
+            }
+        }
+    });
+}
+
+void test_full_scale_reaches_255() {
+    DriveMixer mixer;
+    DriveOutput forward = mixer.mix(255, 255);
+    DriveOutput backward = mixer.mix(0, 0);
+    TEST_ASSERT_EQUAL_INT(255, forward.motor1);
+    TEST_ASSERT_EQUAL_INT(255, forward.motor2);
+    TEST_ASSERT_EQUAL_INT(-255, backward.motor1);
+    TEST_ASSERT_EQUAL_INT(-255, backward.motor2);
+}
+
+void test_center_gives_zero() {
+    forEachConfig([](const DriveMixer &mixer) {
+        DriveOutput out = mixer.mix(128, 128);
+        TEST_ASSERT_EQUAL_INT(0, out.motor1);
+        TEST_ASSERT_EQUAL_INT(0, out.motor2);
+    });
+    // タンクミキサーでは片側が中央なら、もう片側の入力に関係なくそのモーターは止まります
+    DriveMixer tank;
+    for (int v = 0; v < 256; v++) {
+        TEST_ASSERT_EQUAL_INT(0, tank.mix(128, v).motor1);
+        TEST_ASSERT_EQUAL_INT(0, tank.mix(v, 128).motor2);
+    }
+}
+
+// 中央値128を挟んで対称な入力(a と 256 - a)は、符号だけが反転した出力になります
+void test_mirrored_inputs_are_antisymmetric() {
+    forEachConfig([](const DriveMixer &mixer) {
+        for (int a = 1; a < 256; a++) {
+            for (int b = 1; b < 256; b++) {
+                DriveOutput out = mixer.mix(a, b);
+                DriveOutput mirrored = mixer.mix(256 - a, 256 - b);
+                TEST_ASSERT_EQUAL_INT(-out.motor1, mirrored.motor1);
+                TEST_ASSERT_EQUAL_INT(-out.motor2, mirrored.motor2);
+            }
+        }
+    });
+}
+
+void test_adjacent_inputs_are_continuous() {
+    int worstStep = 0;
+    forEachConfig([&worstStep](const DriveMixer &mixer) {
+        for (int a = 0; a < 256; a++) {
+            for (int b = 0; b < 256; b++) {
+                DriveOutput out = mixer.mix(a, b);
+                if (a < 255) {
+                    DriveOutput next = mixer.mix(a + 1, b);
+                    worstStep = max(worstStep, max(abs(next.motor1 - out.motor1), abs(next.motor2 - out.motor2)));
+                }
+                if (b < 255) {
+                    DriveOutput next = mixer.mix(a, b + 1);
+                    worstStep = max(worstStep, max(abs(next.motor1 - out.motor1), abs(next.motor2 - out.motor2)));
+                }
+            }
+        }
+    });
+    printf("largest output step per slider count: %d\n", worstStep);
+    TEST_ASSERT_LESS_OR_EQUAL(MAX_STEP_PER_COUNT, worstStep);
+}
+
+// カーブミキサーで旋回いっぱいのまま、前後入力がデッドバンドを抜けても出力が跳ばないことを確認します
+void test_curvature_has_no_jump_at_deadband_edge() {
+    DriveMixer mixer;
+    mixer.setMode(MIX_CURVATURE);
+    DriveOutput spin = mixer.mix(128, 255);
+    TEST_ASSERT_EQUAL_INT(-255, spin.motor1);
+    TEST_ASSERT_EQUAL_INT(255, spin.motor2);
+    for (int throttle = 128; throttle < 255; throttle++) {
+        DriveOutput out = mixer.mix(throttle, 255);
+        DriveOutput next = mixer.mix(throttle + 1, 255);
+        TEST_ASSERT_INT_WITHIN(MAX_STEP_PER_COUNT, out.motor1, next.motor1);
+        TEST_ASSERT_INT_WITHIN(MAX_STEP_PER_COUNT, out.motor2, next.motor2);
+    }
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_outputs_stay_within_pwm_range);
+    RUN_TEST(test_full_scale_reaches_255);
+    RUN_TEST(test_center_gives_zero);
+    RUN_TEST(test_mirrored_inputs_are_antisymmetric);
+    RUN_TEST(test_adjacent_inputs_are_continuous);
+    RUN_TEST(test_curvature_has_no_jump_at_deadband_edge);
+    return UNITY_END();
+}
@@ -0,0 +1,485 @@
+// ESPNowOtaの受信処理を、疑似ESP-NOW媒体(ロス・重複・順序入れ替えあり)とOTAパーティションの代替で動かします。
+// ホスト側の送信処理はDataStructures.hのフレーム形式に従い、ACKのビットマップに従って欠落チャンクを再送します。
+// 転送の成否・書き込まれたイメージ・消去前のモーター停止を確認し、スループットとメモリ使用量を出力します。
+
+#include <unity.h>
+#include <new>
+#include <stdio.h>
+#include <zlib.h>
+#include "FakeRadio.h"
+#include "FakeOta.h"
+#include "RobotController.h"
+#include "PinConfig.h"
+
+static const uint8_t ROBOT_MAC[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x01};
+static const uint8_t CONTROLLER_MAC[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x02};
+
+static const uint64_t STEP_US = 1000;             // シミュレーションの刻み
+static const uint64_t RETRANSMIT_US = 80000;      // ACKで受信が確認できないチャンクを再送するまでの時間
+static const uint64_t CONTROL_RETRY_US = 100000;  // BEGIN/ENDを再送する間隔
+static const uint64_t ERASE_US = 2000000;         // esp_ota_begin()での消去時間 (1MB程度の消去を想定)
+
+/**
+ * @brief ホスト側のOTA送信処理です。コントローラーと同じMACアドレスから送信します。
+ */
+class OtaSender {
+public:
+    enum Phase { PHASE_BEGIN, PHASE_DATA, PHASE_END, PHASE_DONE, PHASE_FAILED };
+
+    OtaSender(const std::vector<uint8_t> &image, uint32_t announcedCrc32)
+        : phase(PHASE_BEGIN), framesSent(0), retransmits(0), acksReceived(0), stopAfterChunks(-1),
+          replayBeginAtChunk(-1),
+          _imageSize((uint32_t)image.size()), _imageCrc32(announcedCrc32), _ackNextSeq(0), _ackBitmap(0),
+          _lastControlAt(0), _controlSent(false) {
+        uLongf size = compressBound(image.size());
+        _compressed.resize(size);
+        compress2(_compressed.data(), &size, image.data(), image.size(), Z_BEST_COMPRESSION);
+        _compressed.resize(size);
+        _chunkCount = (uint16_t)((_compressed.size() + OTA_CHUNK_PAYLOAD_SIZE - 1) / OTA_CHUNK_PAYLOAD_SIZE);
+        _lastSentAt.assign(_chunkCount, 0);
+        _sent.assign(_chunkCount, false);
+        FakeRadio::instance().attachNode(CONTROLLER_MAC, [this](const uint8_t *, const uint8_t *data, int len) {
+            _onReceive(data, len);
+        });
+    }
+
+    size_t compressedSize() const { return _compressed.size(); }
+    uint16_t chunkCount() const { return _chunkCount; }
+
+    void step(uint64_t now) {
+        switch (phase) {
+        case PHASE_BEGIN:
+            if (_controlDue(now)) {
+                _sendBegin();
+            }
+            break;
+        case PHASE_DATA: {
+            if (replayBeginAtChunk >= 0 && _ackNextSeq >= replayBeginAtChunk) {
+                // 遅れて届いたBEGINの重複を模擬します
+                replayBeginAtChunk = -1;
+                _sendBegin();
+            }
+            // ACKで未受信のチャンクを、ウィンドウの範囲内で送信・再送します (1刻みあたり2フレームまで)
+            int budget = 2;
+            uint16_t end = (uint16_t)std::min<int>(_chunkCount, _ackNextSeq + ESPNowOta::WINDOW_SIZE);
+            if (stopAfterChunks >= 0) {
+                end = (uint16_t)std::min<int>(end, stopAfterChunks);
+            }
+            for (uint16_t seq = _ackNextSeq; seq < end && budget > 0; seq++) {
+                if (_ackBitmap & (1UL << (seq - _ackNextSeq))) {
+                    continue;
+                }
+                if (_sent[seq] && now - _lastSentAt[seq] < RETRANSMIT_US) {
+                    continue;
+                }
+                if (_sent[seq]) {
+                    retransmits++;
+                }
+                _sendChunk(seq);
+                _sent[seq] = true;
+                _lastSentAt[seq] = now;
+                budget--;
+            }
+            break;
+        }
+        case PHASE_END:
+            if (_controlDue(now)) {
+                OtaControlFrame endFrame;
+                endFrame.magic = OTA_FRAME_MAGIC;
+                endFrame.type = OTA_FRAME_END;
+                _send(&endFrame, sizeof(endFrame));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    Phase phase;
+    uint32_t framesSent;
+    uint32_t retransmits;
+    uint32_t acksReceived;
+    int stopAfterChunks; // 0以上の場合、このチャンク数で送信をやめます (送信側の途絶を模擬します)
+    int replayBeginAtChunk; // 0以上の場合、このチャンク数まで受信が確認された時点でBEGINをもう一度送ります
+
+private:
+    bool _controlDue(uint64_t now) {
+        if (_controlSent && now - _lastControlAt < CONTROL_RETRY_US) {
+            return false;
+        }
+        _controlSent = true;
+        _lastControlAt = now;
+        return true;
+    }
+
+    void _sendBegin() {
+        OtaBeginFrame begin;
+        begin.magic = OTA_FRAME_MAGIC;
+        begin.type = OTA_FRAME_BEGIN;
+        begin.chunkCount = _chunkCount;
+        begin.compressedSize = (uint32_t)_compressed.size();
+        begin.imageSize = _imageSize;
+        begin.imageCrc32 = _imageCrc32;
+        _send(&begin, sizeof(begin));
+    }
+
+    void _send(const void *frame, int len) {
+        framesSent++;
+        FakeRadio::instance().transmit(CONTROLLER_MAC, ROBOT_MAC, (const uint8_t *)frame, len);
+    }
+
+    void _sendChunk(uint16_t seq) {
+        // 制御パケットと長さが重ならないよう、常に最大長で送ります
+        OtaDataFrame frame = {};
+        frame.magic = OTA_FRAME_MAGIC;
+        frame.type = OTA_FRAME_DATA;
+        frame.seq = seq;
+        size_t offset = (size_t)seq * OTA_CHUNK_PAYLOAD_SIZE;
+        frame.length = (uint8_t)std::min<size_t>(OTA_CHUNK_PAYLOAD_SIZE, _compressed.size() - offset);
+        memcpy(frame.payload, _compressed.data() + offset, frame.length);
+        _send(&frame, sizeof(frame));
+    }
+
+    void _onReceive(const uint8_t *data, int len) {
+        if (len != sizeof(OtaAckFrame) || data[0] != OTA_FRAME_MAGIC || data[1] != OTA_FRAME_ACK) {
+            return; // テレメトリは無視します
+        }
+        OtaAckFrame ack;
+        memcpy(&ack, data, sizeof(ack));
+        acksReceived++;
+        if (ack.status == OTA_STATUS_ERROR) {
+            phase = PHASE_FAILED;
+            return;
+        }
+        if (ack.status == OTA_STATUS_SUCCESS) {
+            phase = PHASE_DONE;
+            return;
+        }
+        if (ack.status != OTA_STATUS_RECEIVING) {
+            return;
+        }
+        if (phase == PHASE_BEGIN) {
+            phase = PHASE_DATA;
+        }
+        // 順序が入れ替わって届いた古いACKは無視します
+        if (ack.nextSeq >= _ackNextSeq) {
+            _ackNextSeq = ack.nextSeq;
+            _ackBitmap = ack.receivedBitmap;
+        }
+        if (phase == PHASE_DATA && _ackNextSeq >= _chunkCount) {
+            phase = PHASE_END;
+            _controlSent = false;
+        }
+    }
+
+    std::vector<uint8_t> _compressed;
+    uint16_t _chunkCount;
+    uint32_t _imageSize;
+    uint32_t _imageCrc32;
+    uint16_t _ackNextSeq;
+    uint32_t _ackBitmap;
+    std::vector<uint64_t> _lastSentAt;
+    std::vector<bool> _sent;
+    uint64_t _lastControlAt;
+    bool _controlSent;
+};
+
+// 転送の結果です
+struct TransferResult {
+    OtaSender::Phase phase;
+    double seconds;           // BEGIN送信から完了までの仮想時間
+    uint32_t imageBytes;
+    size_t compressedBytes;
+    uint32_t framesSent;
+    uint32_t retransmits;
+    bool motorsStoppedAtErase; // 消去開始時点でモーターとブザーが止まっていたか
+    bool otaActiveAtEnd;
+    int motorDutyAtEnd;        // 終了時のモーター1のデューティ
+};
+
+static RobotController *activeController = nullptr;
+static bool motorsStoppedAtErase = false;
+
+static void onRecvTrampoline(const uint8_t *mac_addr, const uint8_t *data, int len) {
+    activeController->onDataRecv(mac_addr, data, len);
+}
+
+static void onOtaBeginTrampoline() {
+    activeController->onOtaBegin();
+}
+
+// 圧縮率が実際のファームウェアに近くなるよう、繰り返しの多い領域と乱数の領域を混ぜたイメージを作ります
+static std::vector<uint8_t> makeImage(size_t size, uint32_t seed) {
+    std::vector<uint8_t> image(size);
+    std::mt19937 random(seed);
+    for (size_t i = 0; i < size; i++) {
+        image[i] = ((i / 4096) % 3 == 0) ? (uint8_t)random() : (uint8_t)(i * 7 / 64);
+    }
+    return image;
+}
+
+/**
+ * @brief 走行中の機体へOTA転送を行います。
+ * コントローラーは前進・ブザーONの操縦データを送り続け、200ms後から同じMACアドレスでOTA転送を始めます。
+ */
+static TransferResult runTransfer(const RadioLinkConfig &link, uint32_t seed, const std::vector<uint8_t> &image,
+                                  uint32_t announcedCrc32, int stopAfterChunks = -1,
+                                  uint64_t timeLimitUs = 120000000ULL, int replayBeginAtChunk = -1) {
+    FakeClock::reset();
+    FakeLedc::reset();
+    FakeAdc::setValue(4095);
+    FakeOta::reset();
+    FakeOta::setEraseMicros(ERASE_US);
+    ESP.restartCount = 0;
+    FakeRadio &radio = FakeRadio::instance();
+    radio.reset(seed);
+    radio.setDeviceMac(ROBOT_MAC);
+    radio.configure(link);
+
+    Caterpillar caterpillar(IN1, IN2, IN3, IN4, BUZZER,
+                            motorChannel1, motorChannel2, motorChannel3, motorChannel4, buzzerChannel,
+                            WHITE_LED, BLUE_LED, whiteLedChannel, blueLedChannel);
+    ESPNowManager espNowManager;
+    // 実機のグローバル変数と違い未初期化の内容に依存しないよう、0xABで埋めた領域に構築します
+    alignas(ESPNowOta) static unsigned char otaStorage[sizeof(ESPNowOta)];
+    memset(otaStorage, 0xAB, sizeof(otaStorage));
+    ESPNowOta &espNowOta = *new (otaStorage) ESPNowOta();
+    RobotController controller(caterpillar, espNowManager, espNowOta, CONTROLLER_MAC);
+    activeController = &controller;
+    espNowOta.init();
+    espNowOta.setBeginCallback(onOtaBeginTrampoline);
+    TEST_ASSERT_TRUE(espNowManager.init());
+    esp_now_register_recv_cb(onRecvTrampoline);
+    TEST_ASSERT_TRUE(espNowManager.pairDevice(CONTROLLER_MAC));
+
+    OtaSender sender(image, announcedCrc32);
+    sender.stopAfterChunks = stopAfterChunks;
+    sender.replayBeginAtChunk = replayBeginAtChunk;
+    motorsStoppedAtErase = false;
+    FakeOta::setBeginHook([]() {
+        motorsStoppedAtErase = FakeLedc::duty(motorChannel1) == 0 && FakeLedc::duty(motorChannel2) == 0 &&
+                               FakeLedc::duty(motorChannel3) == 0 && FakeLedc::duty(motorChannel4) == 0 &&
+                               FakeLedc::tone(buzzerChannel) == 0;
+    });
+
+    ReceivedDataPacket drive = {};
+    drive.slideVal1 = 255;
+    drive.slideVal2 = 255;
+    drive.sw1 = 0; // ブザーON
+    drive.sw2 = drive.sw3 = drive.sw4 = drive.sw5 = drive.sw6 = drive.sw7 = drive.sw8 = 1;
+    drive.sld_sw1_1 = drive.sld_sw1_2 = drive.sld_sw2_1 = drive.sld_sw2_2 = 1;
+    drive.sld_sw3_1 = drive.sld_sw3_2 = drive.sld_sw4_1 = drive.sld_sw4_2 = 1;
+
+    const uint64_t startUs = FakeClock::nowMicros();
+    const uint64_t otaStartUs = startUs + 200000;
+    uint64_t nextDriveUs = startUs;
+    uint64_t now = startUs;
+    uint64_t deadlineUs = startUs + timeLimitUs;
+    uint64_t finishedUs = 0;
+    while (now < deadlineUs) {
+        if (finishedUs == 0 && (sender.phase == OtaSender::PHASE_DONE || sender.phase == OtaSender::PHASE_FAILED)) {
+            // 転送終了後も操縦データを少し送り続け、制御が再開するかを確認できるようにします
+            finishedUs = now;
+            deadlineUs = std::min(deadlineUs, now + 100000);
+        }
+        if (now >= nextDriveUs) {
+            radio.transmit(CONTROLLER_MAC, ROBOT_MAC, (const uint8_t *)&drive, sizeof(drive));
+            nextDriveUs += RobotController::LOOP_INTERVAL_MS * 1000;
+        }
+        if (now == otaStartUs) {
+            // 転送開始時点で走行中・ブザー鳴動中であることを確認しておきます
+            TEST_ASSERT_GREATER_THAN(0, FakeLedc::duty(motorChannel1));
+            TEST_ASSERT_GREATER_THAN(0, FakeLedc::tone(buzzerChannel));
+        }
+        if (now >= otaStartUs) {
+            sender.step(now);
+        }
+        radio.runUntil(now + STEP_US);
+        controller.update();
+        // 消去やdelay()で仮想時計が進んだ場合は、その時刻から続けます
+        now = std::max(now + STEP_US, FakeClock::nowMicros());
+    }
+
+    TransferResult result;
+    result.phase = sender.phase;
+    result.seconds = ((finishedUs != 0 ? finishedUs : now) - otaStartUs) / 1e6;
+    result.imageBytes = (uint32_t)image.size();
+    result.compressedBytes = sender.compressedSize();
+    result.framesSent = sender.framesSent;
+    result.retransmits = sender.retransmits;
+    result.motorsStoppedAtErase = motorsStoppedAtErase;
+    result.otaActiveAtEnd = espNowOta.isActive();
+    result.motorDutyAtEnd = FakeLedc::duty(motorChannel1);
+    activeController = nullptr;
+    espNowOta.~ESPNowOta();
+    return result;
+}
+
+static void printResult(const char *name, const TransferResult &result, const RadioStats &radio) {
+    printf("[%s] image=%u bytes compressed=%zu bytes time=%.2fs (incl. %.1fs erase) throughput=%.1f KB/s "
+           "frames=%u retransmits=%u radio: tx=%u drop=%u dup=%u\n",
+           name, result.imageBytes, result.compressedBytes, result.seconds, ERASE_US / 1e6,
+           result.imageBytes / 1024.0 / result.seconds, result.framesSent, result.retransmits,
+           radio.transmitted, radio.dropped, radio.duplicated);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_clean_link_updates_image() {
+    std::vector<uint8_t> image = makeImage(256 * 1024, 1);
+    uint32_t crc = crc32(0, image.data(), image.size());
+    TransferResult result = runTransfer(RadioLinkConfig(), 1, image, crc);
+    printResult("clean", result, FakeRadio::instance().getStats());
+
+    TEST_ASSERT_EQUAL_INT(OtaSender::PHASE_DONE, result.phase);
+    TEST_ASSERT_TRUE(FakeOta::image() == image);
+    TEST_ASSERT_TRUE(FakeOta::ended());
+    TEST_ASSERT_TRUE(FakeOta::bootPartitionSet());
+    TEST_ASSERT_EQUAL_INT(1, ESP.restartCount);
+    TEST_ASSERT_TRUE(result.motorsStoppedAtErase);
+}
+
+// ロス・重複・順序入れ替えがあっても、再送で同じイメージが書き込まれます
+void test_lossy_reordering_link_updates_image() {
+    RadioLinkConfig link;
+    link.lossRate = 0.1;
+    link.duplicateRate = 0.05;
+    link.latencyUs = 2000;
+    link.jitterUs = 3000;
+    link.distribution = LATENCY_NORMAL;
+    link.allowReorder = true;
+    std::vector<uint8_t> image = makeImage(256 * 1024, 2);
+    uint32_t crc = crc32(0, image.data(), image.size());
+    TransferResult result = runTransfer(link, 2, image, crc);
+    printResult("lossy+reorder+dup", result, FakeRadio::instance().getStats());
+
+    TEST_ASSERT_EQUAL_INT(OtaSender::PHASE_DONE, result.phase);
+    TEST_ASSERT_GREATER_THAN(0, result.retransmits);
+    TEST_ASSERT_TRUE(FakeOta::image() == image);
+    TEST_ASSERT_TRUE(FakeOta::bootPartitionSet());
+    TEST_ASSERT_EQUAL_INT(1, ESP.restartCount);
+    TEST_ASSERT_TRUE(result.motorsStoppedAtErase);
+}
+
+// データ受信後に同じBEGINが届いても、転送をやり直さずACKを返すだけにします
+void test_late_duplicate_begin_does_not_restart_transfer() {
+    std::vector<uint8_t> image = makeImage(64 * 1024, 5);
+    uint32_t crc = crc32(0, image.data(), image.size());
+    TransferResult baseline = runTransfer(RadioLinkConfig(), 5, image, crc);
+    TransferResult result = runTransfer(RadioLinkConfig(), 5, image, crc, -1, 120000000ULL, 20);
+    printResult("late-begin", result, FakeRadio::instance().getStats());
+
+    TEST_ASSERT_EQUAL_INT(OtaSender::PHASE_DONE, result.phase);
+    TEST_ASSERT_EQUAL_INT(1, FakeOta::beginCount());
+    TEST_ASSERT_FALSE(FakeOta::aborted());
+    TEST_ASSERT_TRUE(FakeOta::image() == image);
+    // 消去のやり直しやタイムアウト待ちがなければ、重複がない場合とほぼ同じ時間で終わります
+    TEST_ASSERT_TRUE(result.seconds < baseline.seconds + 0.5);
+}
+
+// 最大長でないデータフレームは、制御パケットと区別できないため受け付けません
+void test_short_data_frame_is_ignored() {
+    FakeClock::reset();
+    FakeOta::reset();
+    FakeRadio &radio = FakeRadio::instance();
+    radio.reset(6);
+    radio.setDeviceMac(ROBOT_MAC);
+    esp_now_init();
+    esp_now_peer_info_t peer = {};
+    memcpy(peer.peer_addr, CONTROLLER_MAC, 6);
+    esp_now_add_peer(&peer);
+    ESPNowOta ota;
+    TEST_ASSERT_TRUE(ota.init());
+
+    // 1チャンクに収まるよう、繰り返しの多い小さなイメージを使います
+    std::vector<uint8_t> image(2048);
+    for (size_t i = 0; i < image.size(); i++) {
+        image[i] = (uint8_t)(i % 16);
+    }
+    uLongf compressedSize = compressBound(image.size());
+    std::vector<uint8_t> compressed(compressedSize);
+    compress2(compressed.data(), &compressedSize, image.data(), image.size(), Z_BEST_COMPRESSION);
+    TEST_ASSERT_TRUE(compressedSize <= OTA_CHUNK_PAYLOAD_SIZE);
+
+    OtaBeginFrame begin = {OTA_FRAME_MAGIC, OTA_FRAME_BEGIN, 1, (uint32_t)compressedSize,
+                           (uint32_t)image.size(), (uint32_t)crc32(0, image.data(), image.size())};
+    ota.enqueueFrame(CONTROLLER_MAC, (const uint8_t *)&begin, sizeof(begin));
+    ota.process();
+    TEST_ASSERT_TRUE(ota.isActive());
+
+    OtaDataFrame data = {};
+    data.magic = OTA_FRAME_MAGIC;
+    data.type = OTA_FRAME_DATA;
+    data.seq = 0;
+    data.length = (uint8_t)compressedSize;
+    memcpy(data.payload, compressed.data(), compressedSize);
+    int shortLength = (int)(offsetof(OtaDataFrame, payload) + compressedSize);
+    ota.enqueueFrame(CONTROLLER_MAC, (const uint8_t *)&data, shortLength);
+    ota.process();
+    TEST_ASSERT_EQUAL_INT(0, ota.getProgress());
+    TEST_ASSERT_EQUAL_INT(0, (int)FakeOta::image().size());
+
+    ota.enqueueFrame(CONTROLLER_MAC, (const uint8_t *)&data, sizeof(data));
+    ota.process();
+    TEST_ASSERT_EQUAL_INT(100, ota.getProgress());
+    TEST_ASSERT_TRUE(FakeOta::image() == image);
+}
+
+// CRCが一致しない場合は起動パーティションを切り替えず、再起動もしません
+void test_crc_mismatch_is_rejected() {
+    std::vector<uint8_t> image = makeImage(64 * 1024, 3);
+    uint32_t crc = crc32(0, image.data(), image.size());
+    TransferResult result = runTransfer(RadioLinkConfig(), 3, image, crc ^ 1);
+
+    TEST_ASSERT_EQUAL_INT(OtaSender::PHASE_FAILED, result.phase);
+    TEST_ASSERT_TRUE(FakeOta::aborted());
+    TEST_ASSERT_FALSE(FakeOta::bootPartitionSet());
+    TEST_ASSERT_EQUAL_INT(0, ESP.restartCount);
+    TEST_ASSERT_FALSE(result.otaActiveAtEnd);
+}
+
+// 送信側が途絶するとタイムアウトで中止し、その後は操縦データで再び走行します
+void test_sender_silence_times_out_and_driving_resumes() {
+    std::vector<uint8_t> image = makeImage(64 * 1024, 4);
+    uint32_t crc = crc32(0, image.data(), image.size());
+    TransferResult result = runTransfer(RadioLinkConfig(), 4, image, crc, 20,
+                                        (ERASE_US + ESPNowOta::SESSION_TIMEOUT_MS * 1000ULL) * 2);
+
+    TEST_ASSERT_TRUE(FakeOta::aborted());
+    TEST_ASSERT_FALSE(FakeOta::bootPartitionSet());
+    TEST_ASSERT_FALSE(result.otaActiveAtEnd);
+    TEST_ASSERT_GREATER_THAN(0, result.motorDutyAtEnd);
+}
+
+// RAM使用量の内訳を出力し、ESPNowOtaの公開値が実際の確保量と一致することを確認します。
+// tinfl_decompressorはホストではzlibの代替のため、ESP32 (ROM miniz) より小さくなります
+void test_memory_footprint_matches_allocations() {
+    FakeOta::reset();
+    ESPNowOta ota;
+    TEST_ASSERT_TRUE(ota.init());
+    TEST_ASSERT_EQUAL_INT(ESPNowOta::QUEUE_RAM_BYTES, FakeOta::queueBytes());
+    // ウィンドウと展開器はオブジェクトに含まれ、それ以外のメンバーはわずかです
+    size_t members = ESPNowOta::WINDOW_RAM_BYTES + ESPNowOta::INFLATOR_RAM_BYTES;
+    TEST_ASSERT_GREATER_OR_EQUAL(members, sizeof(ESPNowOta));
+    TEST_ASSERT_LESS_THAN(members + 128, sizeof(ESPNowOta));
+    TEST_ASSERT_LESS_OR_EQUAL(ESPNowOta::RAM_BUDGET_BYTES, ESPNowOta::TOTAL_RAM_BYTES);
+
+    printf("[memory] dictionary=%zu (heap, during transfer) inflator=%zu (member) window=%zu (member) "
+           "queue=%zu (heap) object=%zu total=%zu bytes (host build)\n",
+           ESPNowOta::DICT_RAM_BYTES, ESPNowOta::INFLATOR_RAM_BYTES, ESPNowOta::WINDOW_RAM_BYTES,
+           ESPNowOta::QUEUE_RAM_BYTES, sizeof(ESPNowOta), ESPNowOta::TOTAL_RAM_BYTES);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_link_updates_image);
+    RUN_TEST(test_lossy_reordering_link_updates_image);
+    RUN_TEST(test_late_duplicate_begin_does_not_restart_transfer);
+    RUN_TEST(test_short_data_frame_is_ignored);
+    RUN_TEST(test_crc_mismatch_is_rejected);
+    RUN_TEST(test_sender_silence_times_out_and_driving_resumes);
+    RUN_TEST(test_memory_footprint_matches_allocations);
+    return UNITY_END();
+}
@@ -0,0 +1,195 @@
+// InputMapperのエッジ・レベル検出とアクションの割り当て、通信ロス時のリセットを確認します。
+
+#include <unity.h>
+#include "InputMapper.h"
+
+// onMaskでONにしたスイッチ(ビット位置はInputBit)だけを押した受信データを作ります (アクティブロー)
+static ReceivedDataPacket makePacket(uint16_t onMask) {
+    ReceivedDataPacket packet = {};
+    packet.slideVal1 = 128;
+    packet.slideVal2 = 128;
+    int *switches[] = {&packet.sw1, &packet.sw2, &packet.sw3, &packet.sw4,
+                       &packet.sw5, &packet.sw6, &packet.sw7, &packet.sw8,
+                       &packet.sld_sw1_1, &packet.sld_sw1_2, &packet.sld_sw2_1, &packet.sld_sw2_2,
+                       &packet.sld_sw3_1, &packet.sld_sw3_2, &packet.sld_sw4_1, &packet.sld_sw4_2};
+    for (int bit = 0; bit < 16; bit++) {
+        *switches[bit] = (onMask & (1u << bit)) ? 0 : 1;
+    }
+    return packet;
+}
+
+static uint16_t bit(InputBit b) {
+    return (uint16_t)(1u << b);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_pack_switches_is_active_low() {
+    TEST_ASSERT_EQUAL_INT(0, InputMapper::packSwitches(makePacket(0)));
+    TEST_ASSERT_EQUAL_INT(0xFFFF, InputMapper::packSwitches(makePacket(0xFFFF)));
+    uint16_t mask = bit(INPUT_SW3) | bit(INPUT_SLD_SW4_2);
+    TEST_ASSERT_EQUAL_INT(mask, InputMapper::packSwitches(makePacket(mask)));
+}
+
+void test_edges_are_reported_once() {
+    InputMapper mapper;
+    mapper.update(makePacket(bit(INPUT_SW6)));
+    TEST_ASSERT_EQUAL_INT(bit(INPUT_SW6), mapper.getPressed());
+    mapper.update(makePacket(bit(INPUT_SW6)));
+    TEST_ASSERT_EQUAL_INT(0, mapper.getPressed());
+    TEST_ASSERT_EQUAL_INT(bit(INPUT_SW6), mapper.getHeld());
+    mapper.update(makePacket(0));
+    TEST_ASSERT_EQUAL_INT(bit(INPUT_SW6), mapper.getReleased());
+    TEST_ASSERT_EQUAL_INT(0, mapper.getHeld());
+}
+
+void test_horn_follows_sw1() {
+    InputMapper mapper;
+    mapper.update(makePacket(bit(INPUT_SW1)));
+    TEST_ASSERT_TRUE(mapper.getState().horn);
+    mapper.update(makePacket(bit(INPUT_SW1)));
+    TEST_ASSERT_TRUE(mapper.getState().horn);
+    mapper.update(makePacket(0));
+    TEST_ASSERT_FALSE(mapper.getState().horn);
+}
+
+// 押し続けてもライトは1回しか切り替わりません
+void test_lights_toggle_once_per_press() {
+    InputMapper mapper;
+    for (int i = 0; i < 5; i++) {
+        mapper.update(makePacket(bit(INPUT_SW2)));
+    }
+    TEST_ASSERT_TRUE(mapper.getState().lights);
+    mapper.update(makePacket(0));
+    mapper.update(makePacket(bit(INPUT_SW2)));
+    TEST_ASSERT_FALSE(mapper.getState().lights);
+}
+
+void test_speed_gear_is_clamped() {
+    InputMapper mapper;
+    TEST_ASSERT_EQUAL_INT(InputMapper::SPEED_GEAR_COUNT, mapper.getState().speedGear);
+    TEST_ASSERT_EQUAL_INT(DriveMixer::FIXED_ONE, mapper.getSpeedScale());
+    for (int i = 0; i < InputMapper::SPEED_GEAR_COUNT + 2; i++) {
+        mapper.update(makePacket(bit(INPUT_SW4)));
+        mapper.update(makePacket(0));
+    }
+    TEST_ASSERT_EQUAL_INT(1, mapper.getState().speedGear);
+    mapper.update(makePacket(bit(INPUT_SW3)));
+    TEST_ASSERT_EQUAL_INT(2, mapper.getState().speedGear);
+    for (int i = 0; i < InputMapper::SPEED_GEAR_COUNT + 2; i++) {
+        mapper.update(makePacket(0));
+        mapper.update(makePacket(bit(INPUT_SW3)));
+    }
+    TEST_ASSERT_EQUAL_INT(InputMapper::SPEED_GEAR_COUNT, mapper.getState().speedGear);
+}
+
+void test_mix_mode_cycles_on_sw5() {
+    InputMapper mapper;
+    TEST_ASSERT_EQUAL_INT(MIX_TANK, mapper.getState().mixMode);
+    for (int i = 1; i <= MIX_MODE_COUNT; i++) {
+        mapper.update(makePacket(bit(INPUT_SW5)));
+        mapper.update(makePacket(0));
+        TEST_ASSERT_EQUAL_INT(i % MIX_MODE_COUNT, mapper.getState().mixMode);
+    }
+}
+
+void test_slide_switch_sets_drive_mode() {
+    InputMapper mapper;
+    mapper.update(makePacket(bit(INPUT_SLD_SW1_2)));
+    TEST_ASSERT_EQUAL_INT(DRIVE_MODE_REVERSED, mapper.getState().driveMode);
+    mapper.update(makePacket(0));
+    TEST_ASSERT_EQUAL_INT(DRIVE_MODE_NORMAL, mapper.getState().driveMode);
+}
+
+void test_slide_switch_2_selects_expo() {
+    InputMapper mapper;
+    TEST_ASSERT_FALSE(mapper.getState().softExpo);
+    mapper.update(makePacket(bit(INPUT_SLD_SW2_2)));
+    TEST_ASSERT_TRUE(mapper.getState().softExpo);
+    // 位置で決まるため、他のスイッチを操作しても保持されます
+    mapper.update(makePacket(bit(INPUT_SLD_SW2_2) | bit(INPUT_SW5)));
+    TEST_ASSERT_TRUE(mapper.getState().softExpo);
+    mapper.update(makePacket(0));
+    TEST_ASSERT_FALSE(mapper.getState().softExpo);
+}
+
+// 通信ロス中にスライドスイッチをOFFにしても、復帰後は通常走行に戻ります
+void test_slide_switch_moved_during_link_loss_is_followed() {
+    InputMapper mapper;
+    mapper.update(makePacket(bit(INPUT_SLD_SW1_2)));
+    TEST_ASSERT_EQUAL_INT(DRIVE_MODE_REVERSED, mapper.getState().driveMode);
+    mapper.reset();
+    mapper.update(makePacket(0));
+    TEST_ASSERT_EQUAL_INT(DRIVE_MODE_NORMAL, mapper.getState().driveMode);
+
+    // 逆に通常走行中にONにした場合も、復帰後は前後反転走行になります
+    mapper.reset();
+    mapper.update(makePacket(bit(INPUT_SLD_SW1_2)));
+    TEST_ASSERT_EQUAL_INT(DRIVE_MODE_REVERSED, mapper.getState().driveMode);
+}
+
+// リセットではブザーだけを止め、ライト・速度ギア・ミキサーは保持します
+void test_reset_stops_horn_and_keeps_settings() {
+    InputMapper mapper;
+    mapper.update(makePacket(bit(INPUT_SW2)));
+    mapper.update(makePacket(bit(INPUT_SW4)));
+    mapper.update(makePacket(bit(INPUT_SW5)));
+    mapper.update(makePacket(bit(INPUT_SW1)));
+    TEST_ASSERT_TRUE(mapper.getState().horn);
+
+    mapper.reset();
+    TEST_ASSERT_FALSE(mapper.getState().horn);
+    TEST_ASSERT_EQUAL_INT(bit(INPUT_SW1), mapper.getHeld());
+    TEST_ASSERT_TRUE(mapper.getState().lights);
+    TEST_ASSERT_EQUAL_INT(InputMapper::SPEED_GEAR_COUNT - 1, mapper.getState().speedGear);
+    TEST_ASSERT_EQUAL_INT(MIX_ARCADE, mapper.getState().mixMode);
+
+    // 復帰時にSW1が押されたままでも、押し直すまでブザーは鳴りません
+    mapper.update(makePacket(bit(INPUT_SW1)));
+    TEST_ASSERT_FALSE(mapper.getState().horn);
+    mapper.update(makePacket(0));
+    mapper.update(makePacket(bit(INPUT_SW1)));
+    TEST_ASSERT_TRUE(mapper.getState().horn);
+}
+
+// 通信ロスをまたいでボタンを押し続けても、復帰時に再びアクションが実行されることはありません
+void test_buttons_held_across_reset_do_not_retrigger() {
+    InputMapper mapper;
+    uint16_t held = bit(INPUT_SW2) | bit(INPUT_SW3) | bit(INPUT_SW5);
+    mapper.update(makePacket(bit(INPUT_SW4)));
+    mapper.update(makePacket(held));
+    ControlState before = mapper.getState();
+    TEST_ASSERT_EQUAL_INT(MIX_ARCADE, before.mixMode);
+
+    mapper.reset();
+    mapper.update(makePacket(held));
+    TEST_ASSERT_EQUAL_INT(0, mapper.getPressed());
+    TEST_ASSERT_EQUAL_INT(before.mixMode, mapper.getState().mixMode);
+    TEST_ASSERT_EQUAL_INT(before.lights, mapper.getState().lights);
+    TEST_ASSERT_EQUAL_INT(before.speedGear, mapper.getState().speedGear);
+
+    // 途絶中に離して押し直した場合は、復帰後に押下として扱います
+    mapper.reset();
+    mapper.update(makePacket(bit(INPUT_SW2) | bit(INPUT_SW3)));
+    TEST_ASSERT_EQUAL_INT(bit(INPUT_SW5), mapper.getReleased());
+    mapper.update(makePacket(held));
+    TEST_ASSERT_EQUAL_INT((before.mixMode + 1) % MIX_MODE_COUNT, mapper.getState().mixMode);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pack_switches_is_active_low);
+    RUN_TEST(test_edges_are_reported_once);
+    RUN_TEST(test_horn_follows_sw1);
+    RUN_TEST(test_lights_toggle_once_per_press);
+    RUN_TEST(test_speed_gear_is_clamped);
+    RUN_TEST(test_mix_mode_cycles_on_sw5);
+    RUN_TEST(test_slide_switch_sets_drive_mode);
+    RUN_TEST(test_slide_switch_2_selects_expo);
+    RUN_TEST(test_slide_switch_moved_during_link_loss_is_followed);
+    RUN_TEST(test_reset_stops_horn_and_keeps_settings);
+    RUN_TEST(test_buttons_held_across_reset_do_not_retrigger);
+    return UNITY_END();
+}
@@ -0,0 +1,255 @@
+// 疑似ESP-NOW媒体でコントローラーから操縦データを送り、RobotControllerの受信・制御処理を
+// そのまま動かして、操縦から動作反映までの遅延・フェイルセーフ発生回数・1パケットあたりの処理時間を計測します。
+
+#include <unity.h>
+#include <chrono>
+#include <deque>
+#include <stdio.h>
+#include "FakeRadio.h"
+#include "FakeOta.h"
+#include "RobotController.h"
+#include "PinConfig.h"
+
+static const uint8_t ROBOT_MAC[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x01};
+static const uint8_t CONTROLLER_MAC[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x02};
+
+// 計測シナリオです
+struct Scenario {
+    const char *name;
+    RadioLinkConfig link;
+    int interferers;            // 機体とは無関係に媒体を使う送信元の数
+    uint32_t interfererPeriodMs; // 干渉ノードの送信間隔
+    uint32_t durationMs;        // 計測時間
+    uint32_t outageStartMs;     // この時刻から通信を完全に途絶させます (0で途絶なし)
+    uint32_t outageMs;          // 途絶させる時間
+};
+
+// 計測結果です
+struct Report {
+    uint32_t commandsSent;
+    uint32_t commandsActuated;
+    uint32_t latencyP50Us;
+    uint32_t latencyP90Us;
+    uint32_t latencyP99Us;
+    uint32_t latencyMaxUs;
+    uint32_t failsafeTrips;
+    uint32_t packetsToDevice;
+    double cpuNsPerPacket;
+    RadioStats radio;
+};
+
+// コントローラーの送信周期です。機体の制御周期と位相がずれていくよう、わずかに異なる値にしています
+static const uint64_t COMMAND_PERIOD_US = 20000 + 130;
+
+static RobotController *activeController = nullptr;
+static double controlNanos = 0;
+static uint32_t controlPackets = 0;
+
+static void onRecvTrampoline(const uint8_t *mac_addr, const uint8_t *data, int len) {
+    auto start = std::chrono::steady_clock::now();
+    activeController->onDataRecv(mac_addr, data, len);
+    controlPackets++;
+    controlNanos += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static uint32_t percentile(std::vector<uint32_t> values, int percent) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t rank = (values.size() * percent + 99) / 100;
+    return values[rank > 0 ? rank - 1 : 0];
+}
+
+/**
+ * @brief シナリオを実行し、結果を返します。
+ * コントローラーは20msごとにスライダー1の値を変えた操縦データを送信し、
+ * その値に対応するモーター1のPWM出力が現れた時刻を動作反映とみなします。
+ */
+static Report runScenario(const Scenario &scenario, uint32_t seed) {
+    FakeClock::reset();
+    FakeLedc::reset();
+    FakeAdc::setValue(4095);
+    FakeOta::reset();
+    FakeRadio &radio = FakeRadio::instance();
+    radio.reset(seed);
+    radio.setDeviceMac(ROBOT_MAC);
+    radio.configure(scenario.link);
+    radio.attachNode(CONTROLLER_MAC, [](const uint8_t *, const uint8_t *, int) {});
+
+    // main.cppのsetup()と同じ手順で組み立てます
+    Caterpillar caterpillar(IN1, IN2, IN3, IN4, BUZZER,
+                            motorChannel1, motorChannel2, motorChannel3, motorChannel4, buzzerChannel,
+                            WHITE_LED, BLUE_LED, whiteLedChannel, blueLedChannel);
+    ESPNowManager espNowManager;
+    ESPNowOta espNowOta;
+    RobotController controller(caterpillar, espNowManager, espNowOta, CONTROLLER_MAC);
+    activeController = &controller;
+    controlNanos = 0;
+    controlPackets = 0;
+    espNowOta.init();
+    TEST_ASSERT_TRUE(espNowManager.init());
+    esp_now_register_recv_cb(onRecvTrampoline);
+    TEST_ASSERT_TRUE(espNowManager.pairDevice(CONTROLLER_MAC));
+
+    // 操縦値ごとに期待するモーター1のPWM値を、機体と同じ設定のミキサーで求めておきます
+    DriveMixer expectedMixer;
+    struct Pending {
+        uint64_t sentAt;
+        int duty;
+    };
+    std::deque<Pending> pending;
+    std::vector<uint32_t> latencies;
+    Report report = {};
+    int lastDuty = -1;
+    const uint64_t startUs = FakeClock::nowMicros();
+    const uint64_t endUs = startUs + (uint64_t)scenario.durationMs * 1000;
+    RadioLinkConfig outageLink = scenario.link;
+    outageLink.lossRate = 1.0;
+    uint64_t nextCommandUs = startUs;
+
+    for (uint64_t now = startUs; now < endUs; now += 1000) {
+        uint32_t elapsedMs = (uint32_t)((now - startUs) / 1000);
+        if (scenario.outageMs > 0) {
+            bool inOutage = elapsedMs >= scenario.outageStartMs && elapsedMs < scenario.outageStartMs + scenario.outageMs;
+            radio.configure(inOutage ? outageLink : scenario.link);
+        }
+
+        if (now >= nextCommandUs) {
+            nextCommandUs += COMMAND_PERIOD_US;
+            ReceivedDataPacket packet = {};
+            packet.slideVal1 = 160 + (int)(report.commandsSent % 96);
+            packet.slideVal2 = 128;
+            // スイッチはすべてOFF (アクティブロー)
+            packet.sld_sw1_1 = packet.sld_sw1_2 = packet.sld_sw2_1 = packet.sld_sw2_2 = 1;
+            packet.sld_sw3_1 = packet.sld_sw3_2 = packet.sld_sw4_1 = packet.sld_sw4_2 = 1;
+            packet.sw1 = packet.sw2 = packet.sw3 = packet.sw4 = 1;
+            packet.sw5 = packet.sw6 = packet.sw7 = packet.sw8 = 1;
+            radio.transmit(CONTROLLER_MAC, ROBOT_MAC, (const uint8_t *)&packet, sizeof(packet));
+            pending.push_back({now, expectedMixer.mix(packet.slideVal1, packet.slideVal2).motor1});
+            report.commandsSent++;
+        }
+
+        for (int i = 0; i < scenario.interferers; i++) {
+            // 送信タイミングをずらしながら、機体宛てでない最大長のフレームで媒体を占有します
+            if ((elapsedMs + i * 3) % scenario.interfererPeriodMs == 0) {
+                uint8_t src[6] = {0x02, 0x00, 0x00, 0x00, 0x01, (uint8_t)i};
+                uint8_t dst[6] = {0x02, 0x00, 0x00, 0x00, 0x02, (uint8_t)i};
+                uint8_t payload[ESP_NOW_MAX_DATA_LEN] = {};
+                radio.transmit(src, dst, payload, sizeof(payload));
+            }
+        }
+
+        radio.runUntil(now + 1000);
+        auto start = std::chrono::steady_clock::now();
+        controller.update();
+        controlNanos += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        int duty = FakeLedc::duty(motorChannel1);
+        if (duty != lastDuty) {
+            lastDuty = duty;
+            // 反映された値を送った操縦データを探し、それ以前のものは上書きされたものとして捨てます
+            for (size_t i = 0; i < pending.size(); i++) {
+                if (pending[i].duty == duty) {
+                    latencies.push_back((uint32_t)(FakeClock::nowMicros() - pending[i].sentAt));
+                    report.commandsActuated++;
+                    pending.erase(pending.begin(), pending.begin() + i + 1);
+                    break;
+                }
+            }
+        }
+    }
+
+    report.latencyP50Us = percentile(latencies, 50);
+    report.latencyP90Us = percentile(latencies, 90);
+    report.latencyP99Us = percentile(latencies, 99);
+    report.latencyMaxUs = percentile(latencies, 100);
+    report.failsafeTrips = controller.getLinkStats().failsafeTrips;
+    report.radio = radio.getStats();
+    report.packetsToDevice = controlPackets;
+    // 受信コールバックと制御処理にかかったホスト上の時間を、機体が受信したパケット数で割ります
+    report.cpuNsPerPacket = controlNanos / std::max<uint32_t>(1, controlPackets);
+    activeController = nullptr;
+
+    printf("[%s] sent=%u received=%u actuated=%u latency p50=%uus p90=%uus p99=%uus max=%uus failsafe=%u "
+           "cpu=%.0fns/packet radio: tx=%u drop=%u dup=%u delivered=%u\n",
+           scenario.name, report.commandsSent, report.packetsToDevice, report.commandsActuated, report.latencyP50Us,
+           report.latencyP90Us, report.latencyP99Us, report.latencyMaxUs, report.failsafeTrips,
+           report.cpuNsPerPacket, report.radio.transmitted, report.radio.dropped, report.radio.duplicated,
+           report.radio.delivered);
+    return report;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// 理想的な通信路では全操縦データが反映され、遅延は伝搬遅延+制御周期(20ms)以内に収まります
+void test_clean_link_actuates_every_command() {
+    Scenario scenario = {"clean", RadioLinkConfig(), 0, 10, 5000, 0, 0};
+    Report report = runScenario(scenario, 1);
+    TEST_ASSERT_GREATER_OR_EQUAL(report.commandsSent - 2, report.commandsActuated);
+    TEST_ASSERT_LESS_OR_EQUAL(RobotController::LOOP_INTERVAL_MS * 1000 + 4000, report.latencyP99Us);
+    TEST_ASSERT_EQUAL_UINT32(0, report.failsafeTrips);
+}
+
+// 途絶が200msを超えるとフェイルセーフが1回だけ発生し、復帰後は再び反映されます
+void test_outage_trips_failsafe_once_and_recovers() {
+    Scenario scenario = {"outage", RadioLinkConfig(), 0, 10, 4000, 1000, 500};
+    Report report = runScenario(scenario, 2);
+    TEST_ASSERT_EQUAL_UINT32(1, report.failsafeTrips);
+    // 途絶中の25回分を除き、ほぼすべて反映されます
+    TEST_ASSERT_GREATER_OR_EQUAL(report.commandsSent - 30, report.commandsActuated);
+}
+
+// ロス・ジッター・重複・順序入れ替えがあっても、遅延の裾は制限され、フェイルセーフは発生しません
+void test_lossy_jittery_link_stays_in_control() {
+    RadioLinkConfig link;
+    link.lossRate = 0.2;
+    link.duplicateRate = 0.2;
+    link.latencyUs = 3000;
+    link.jitterUs = 4000;
+    link.distribution = LATENCY_NORMAL;
+    link.allowReorder = true;
+    Scenario scenario = {"lossy+jitter+dup", link, 0, 10, 10000, 0, 0};
+    Report report = runScenario(scenario, 3);
+    TEST_ASSERT_GREATER_THAN(0, report.radio.duplicated);
+    TEST_ASSERT_GREATER_OR_EQUAL(report.commandsSent * 7 / 10, report.commandsActuated);
+    TEST_ASSERT_LESS_OR_EQUAL(60000, report.latencyP99Us);
+    TEST_ASSERT_EQUAL_UINT32(0, report.failsafeTrips);
+}
+
+// 裾の長い遅延分布では、パケットが届いていても遅延の99パーセンタイルが大きくなります
+void test_long_tail_latency_is_visible_in_percentiles() {
+    RadioLinkConfig link;
+    link.latencyUs = 1000;
+    link.jitterUs = 15000;
+    link.distribution = LATENCY_EXPONENTIAL;
+    link.allowReorder = false;
+    Scenario scenario = {"long-tail", link, 0, 10, 10000, 0, 0};
+    Report report = runScenario(scenario, 4);
+    TEST_ASSERT_GREATER_THAN(report.latencyP50Us, report.latencyP99Us);
+    TEST_ASSERT_GREATER_THAN(RobotController::LOOP_INTERVAL_MS * 1000 + 20000, report.latencyP99Us);
+}
+
+// 多数の送信元で媒体が飽和すると、衝突待ちで遅延が増え続けます (24台 x 2ms / 40ms = 負荷1.2)
+void test_congestion_from_many_senders_increases_latency() {
+    Scenario clean = {"congestion-baseline", RadioLinkConfig(), 0, 10, 3000, 0, 0};
+    Scenario busy = {"congestion-24-senders", RadioLinkConfig(), 24, 40, 3000, 0, 0};
+    Report baseline = runScenario(clean, 5);
+    Report congested = runScenario(busy, 5);
+    TEST_ASSERT_GREATER_THAN(baseline.latencyP99Us * 5, congested.latencyP99Us);
+    TEST_ASSERT_GREATER_THAN(0, congested.commandsActuated);
+    // パケットは届き続けるため、遅延が大きくてもフェイルセーフは発生しません
+    TEST_ASSERT_EQUAL_UINT32(0, congested.failsafeTrips);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_link_actuates_every_command);
+    RUN_TEST(test_outage_trips_failsafe_once_and_recovers);
+    RUN_TEST(test_lossy_jittery_link_stays_in_control);
+    RUN_TEST(test_long_tail_latency_is_visible_in_percentiles);
+    RUN_TEST(test_congestion_from_many_senders_increases_latency);
+    return UNITY_END();
+}